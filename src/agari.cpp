@@ -0,0 +1,67 @@
+#include "agari.h"
+#include "mapped_file.h"
+
+namespace {
+    MappedFile tableFile;
+    const AgariHeader* header = nullptr;
+    const uint32_t* seeds = nullptr;
+    const AgariRecord* records = nullptr;
+}
+
+AgariShape::AgariShape(const uint8_t counts[TILE_TYPES]) {
+    int tiles = 0;
+    bool inBlock = false;
+    for (int i = 0; i < TILE_TYPES; ++i) {
+        if (counts[i] == 0) {
+            inBlock = false;
+            continue;
+        }
+        // honors and first tile of each suit always start a block
+        bool blockStart = i < 8 || i == 16 || i == 25 || !inBlock;
+        if (positions && blockStart) key *= 5;
+        key = key * 5 + counts[i];
+        positionTypes[positions++] = i;
+        tiles += counts[i];
+        inBlock = i >= 7;
+        if (positions == MAX_AGARI_POSITIONS) {
+            // more types than any complete hand holds
+            key = 0;
+            break;
+        }
+    }
+    groups = (tiles - 2) / 3;
+}
+
+uint64_t agariHash(uint64_t key, uint32_t seed) {
+    // splitmix64 finalizer
+    uint64_t x = key + (uint64_t)seed * 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+bool AgariTable::load(const std::string& path) {
+    header = nullptr;
+    if (!tableFile.open(path) || tableFile.size() < sizeof(AgariHeader)) return false;
+    const AgariHeader* fileHeader = (const AgariHeader*)tableFile.data();
+    size_t expectedSize = sizeof(AgariHeader) + fileHeader->bucketCount * sizeof(uint32_t) + fileHeader->recordCount * sizeof(AgariRecord);
+    if (fileHeader->magic != AGARI_MAGIC || fileHeader->version != AGARI_VERSION || fileHeader->bucketCount == 0 || fileHeader->recordCount == 0 || tableFile.size() != expectedSize) {
+        tableFile.close();
+        return false;
+    }
+    header = fileHeader;
+    seeds = (const uint32_t*)(tableFile.data() + sizeof(AgariHeader));
+    records = (const AgariRecord*)(seeds + header->bucketCount);
+    return true;
+}
+
+bool AgariTable::loaded() {
+    return header != nullptr;
+}
+
+const AgariRecord* AgariTable::find(const AgariShape& shape) {
+    if (!header || !shape.key) return nullptr;
+    uint32_t seed = seeds[agariHash(shape.key, 0) % header->bucketCount];
+    const AgariRecord* record = records + agariHash(shape.key, seed) % header->recordCount;
+    return record->key == shape.key ? record : nullptr;
+}
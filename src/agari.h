@@ -0,0 +1,61 @@
+#pragma once
+
+#include "board.h"
+#include <string>
+
+/* agari table file layout (native endianness)
+    AgariHeader
+    uint32_t seeds[bucketCount] - displacement seed per bucket (minimal perfect hash over shape keys)
+    AgariRecord records[recordCount] - record of key stored at slot agariHash(key, seeds[agariHash(key, 0) % bucketCount]) % recordCount
+shape keys
+    closed counts read in type order as base 5 digits, 1-4 for a count and 0 between blocks
+    a block is a single honor type or a maximal run of consecutive non-empty types of one suit
+    hands with equal keys decompose identically, positions index the non-empty types in key order
+*/
+
+const uint32_t AGARI_MAGIC = 0x49524741; // "AGRI"
+const uint32_t AGARI_VERSION = 1; // bump when layout or key encoding changes
+const size_t MAX_AGARI_POSITIONS = 14; // max non-empty tile types in a closed hand
+const size_t MAX_AGARI_DECOMPOSITIONS = 10; // max distinct group decompositions of a closed shape
+
+// decomposition bits: pair position (4 bits), then per group run flag (1 bit) and start position (4 bits)
+// group yaku are judged by the scorer on the whole group set (call melds included), so no shape flags are stored
+
+struct AgariHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordCount;
+    uint32_t bucketCount;
+};
+
+struct AgariRecord {
+    uint64_t key; // shape key (verifies lookup, 0 for unused slots)
+    uint8_t decompositionCount; // number of 4 groups 1 pair style decompositions
+    uint8_t reserved[3];
+    uint32_t decompositions[MAX_AGARI_DECOMPOSITIONS];
+};
+
+// normalized shape of closed tile counts
+struct AgariShape {
+    uint64_t key = 0; // shape key
+    int8_t positionTypes[MAX_AGARI_POSITIONS]; // type index at each position
+    int8_t positions = 0; // number of non-empty types
+    int8_t groups = 0; // number of groups besides the pair
+    AgariShape(const uint8_t counts[TILE_TYPES]);
+};
+
+uint64_t agariHash(uint64_t key, uint32_t seed); // hash family of the table's minimal perfect hash
+
+// decomposition field accessors
+inline int8_t agariPairPosition(uint32_t decomposition) { return decomposition & 0b1111; }
+inline bool agariGroupRun(uint32_t decomposition, int group) { return (decomposition >> (4 + group * 5)) & 1; }
+inline int8_t agariGroupPosition(uint32_t decomposition, int group) { return (decomposition >> (5 + group * 5)) & 0b1111; }
+
+// precomputed decompositions of every complete closed shape of 0 to 4 groups plus a pair (7 pairs are scored separately)
+// generated offline by tools/agari_gen and memory mapped at startup, so processes share one read-only copy
+class AgariTable {
+public:
+    static bool load(const std::string& path); // maps table file, false if missing or another version (scoring then searches)
+    static bool loaded(); // whether a table is mapped
+    static const AgariRecord* find(const AgariShape& shape); // record of a complete shape, nullptr if shape has no groups and pair decomposition
+};
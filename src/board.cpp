@@ -1,9 +1,10 @@
 #include "board.h"
+#include "agari.h"
+#include "engine_stats.h"
 #include <utility>
 #include <vector>
 #include <algorithm>
 #include <iostream>
-#include <deque>
 #include <cstring>
 
 // set of valid groups (can have multiple per hand, points is max value meld set)
@@ -28,33 +29,114 @@ public:
     }
 };
 
-inline TileType Tile::operator*() const { return type & (TileType)0b0111111; }
-inline bool Tile::isRed() const { return (bool)(type & 0b1000000); }
-inline void Tile::setLastAction(Action action, int turn) {
-    lastAction = action;
-    lastActionTurn = turn;
+void Hand::updateWaits() {
+    uint8_t closedCounts[TILE_TYPES];
+    std::memcpy(closedCounts, counts, sizeof(counts));
+    ronMask = waitMask(closedCounts);
+    waitCount = 0;
+    for (int i = 0; i < TILE_TYPES; ++i)
+        if ((ronMask >> i) & 1)
+            waits[waitCount++].tileType = INDEX_TYPE_MAP[i];
 }
-inline Tile::Action Tile::getLastAction() const { return lastAction; }
-inline int Tile::getLastActionTurn() const { return lastActionTurn; }
 
+void Hand::updateCount(TileType tileType, int delta) {
+    int8_t t = TYPE_INDEX_MAP[tileType];
+    counts[t] += delta;
+    uint64_t bit = 1ull << t;
+    heldMask = counts[t] >= 1 ? heldMask | bit : heldMask & ~bit;
+    ponMask = counts[t] >= 2 ? ponMask | bit : ponMask & ~bit;
+    kanMask = counts[t] >= 3 ? kanMask | bit : kanMask & ~bit;
+    if (t < 7) return;
+
+    // recompute chi bits of the suit from held bits (x chi-able if x-2,x-1 or x-1,x+1 or x+1,x+2 held)
+    int base = 7 + (t - 7) / 9 * 9;
+    const uint64_t suitMask = 0b111111111ull;
+    uint64_t held = (heldMask >> base) & suitMask;
+    uint64_t chi = ((held << 2) & (held << 1)) | ((held << 1) & (held >> 1)) | ((held >> 1) & (held >> 2));
+    chiMask = (chiMask & ~(suitMask << base)) | ((chi & suitMask) << base);
+}
 
-inline TileType Hand::operator[](size_t index) const { return *tiles[index]; }
-inline void Hand::swapDrawn(size_t index) { std::swap(tiles[index], tiles[DRAWN_I]); }
-inline Tile Hand::discardDrawn() {
-    Tile drawnTile;
-    std::swap(drawnTile, tiles[DRAWN_I]);
-    return drawnTile;
+void Hand::setTile(size_t index, Tile tile) {
+    tiles[index] = tile;
+    updateCount(*tile, 1);
 }
-inline void Hand::clear() {
-    for (int i = 0; i < MAX_HAND_SIZE; ++i)
-        tiles[i] = NONE;
-    callMeldCount = 0;
-    callTiles = 0;
-    waitCount = 0;
+
+void Hand::recount() {
+    std::memset(counts, 0, sizeof(counts));
+    std::memset(callCounts, 0, sizeof(callCounts));
+    for (int i = 0; i < callTiles; ++i)
+        ++callCounts[TYPE_INDEX_MAP[*tiles[i]]];
+    heldMask = 0;
+    ponMask = 0;
+    kanMask = 0;
+    chiMask = 0;
+    for (int i = callTiles; i < MAX_HAND_SIZE; ++i)
+        if (*tiles[i] != NONE) updateCount(*tiles[i], 1);
+}
+
+void Hand::call(uint32_t handMask, Tile claimed, bool open) {
+    // split closed tiles into meld and remaining tiles
+    Tile meld[4];
+    int meldSize = 0;
+    Tile closed[MAX_HAND_SIZE];
+    int closedCount = 0;
+    for (int i = callTiles; i < MAX_HAND_SIZE; ++i) {
+        if (*tiles[i] == NONE) continue;
+        if ((handMask >> i) & 1) {
+            meld[meldSize++] = tiles[i];
+            updateCount(*tiles[i], -1);
+        } else {
+            closed[closedCount++] = tiles[i];
+        }
+    }
+    if (*claimed != NONE) meld[meldSize++] = claimed;
+    for (int i = 1; i < meldSize; ++i)
+        for (int j = i; j > 0 && *meld[j] < *meld[j-1]; --j)
+            std::swap(meld[j], meld[j-1]);
+
+    // append meld to call tiles
+    Group& group = callMelds[callMeldCount++] = Group(meldSize, open, true);
+    for (int i = 0; i < meldSize; ++i) {
+        group[i] = callTiles;
+        ++callCounts[TYPE_INDEX_MAP[*meld[i]]];
+        tiles[callTiles++] = meld[i];
+    }
+
+    // pack remaining closed tiles after call tiles (drawn slot left empty)
+    for (int i = callTiles; i < MAX_HAND_SIZE; ++i)
+        tiles[i] = i - callTiles < closedCount ? closed[i - callTiles] : Tile();
 }
 
-void Hand::updateWaits(const Player& player) {
-    // TODO
+void Hand::extendCall(size_t index) {
+    Tile added = tiles[index];
+    tiles[index] = Tile();
+    updateCount(*added, -1);
+    Tile closed[MAX_HAND_SIZE];
+    int closedCount = 0;
+    for (int i = callTiles; i < MAX_HAND_SIZE; ++i)
+        if (*tiles[i] != NONE) closed[closedCount++] = tiles[i];
+
+    // find called triplet of same type
+    int m;
+    for (m = 0; m < callMeldCount; ++m)
+        if (callMelds[m].size() == 3 && (*this)[callMelds[m][0]] == *added && (*this)[callMelds[m][1]] == *added) break;
+
+    // shift later call tiles right to make room after the triplet
+    int8_t end = callMelds[m][2] + 1;
+    for (int i = callTiles; i > end; --i) tiles[i] = tiles[i-1];
+    tiles[end] = added;
+    ++callCounts[TYPE_INDEX_MAP[*added]];
+    ++callTiles;
+    for (int j = 0; j < callMeldCount; ++j)
+        for (int k = 0; k < callMelds[j].size(); ++k)
+            if (callMelds[j][k] >= end) ++callMelds[j][k];
+    Group kan(4, callMelds[m].open(), true);
+    for (int k = 0; k < 3; ++k) kan[k] = callMelds[m][k];
+    kan[3] = end;
+    callMelds[m] = kan;
+
+    for (int i = callTiles; i < MAX_HAND_SIZE; ++i)
+        tiles[i] = i - callTiles < closedCount ? closed[i - callTiles] : Tile();
 }
 
 inline bool Group::valid(const Hand& hand) const {
@@ -76,11 +158,6 @@ inline uint32_t Group::mask() const {
     return mask;
 }
 
-inline int8_t& Group::operator[](int8_t index) { return tileIndices[index]; }
-inline int8_t Group::size() const { return _size; }
-inline bool Group::open() const { return _open; }
-inline bool Group::locked() const { return _locked; }
-
 const std::array<TileType, 1 << 7> initDoraMap() {
     std::array<TileType, 1 << 7> doraMap;
     doraMap[NONE] = NONE;
@@ -92,12 +169,48 @@ const std::array<TileType, 1 << 7> initDoraMap() {
     return doraMap;
 }
 
+const std::array<int8_t, 1 << 6> initTypeIndexMap() {
+    std::array<int8_t, 1 << 6> typeIndexMap;
+    typeIndexMap.fill(-1);
+    int8_t index = 0;
+    for (TileType tileType = DGNW; tileType <= MAN9; ++tileType)
+        if ((tileType >> 4) == 0 ? tileType <= WNDN : (tileType & 0b1111) >= 1 && (tileType & 0b1111) <= 9)
+            typeIndexMap[tileType] = index++;
+    return typeIndexMap;
+}
+
+const std::array<TileType, TILE_TYPES> initIndexTypeMap() {
+    std::array<TileType, TILE_TYPES> indexTypeMap;
+    const std::array<int8_t, 1 << 6> typeIndexMap = initTypeIndexMap();
+    for (TileType tileType = 0; tileType < (1 << 6); ++tileType)
+        if (typeIndexMap[tileType] != -1) indexTypeMap[typeIndexMap[tileType]] = tileType;
+    return indexTypeMap;
+}
+
 void Player::initRound() {
     discardCount = 0;
     hand.clear();
+    riichiTurn = 0;
     lastTurn = 0;
     firstTurn = 0;
     ronActive = false;
+    discardMask = 0;
+    safeMask = 0;
+    earlyMask = 0;
+    riichiTile = -1;
+    tempFuriten = false;
+    riichiFuriten = false;
+    ronYakuMask = 0;
+    ronYakuScored = false;
+}
+
+void Player::discard(Tile tile) {
+    discards[discardCount++] = tile;
+    uint64_t bit = 1ull << TYPE_INDEX_MAP[*tile];
+    discardMask |= bit;
+    safeMask |= bit;
+    if (discardCount <= EARLY_DISCARDS) earlyMask |= bit;
+    tempFuriten = false;
 }
 
 // gets next tile in run
@@ -110,13 +223,183 @@ inline TileType prevInRun(TileType tileType) {
     return (tileType & 0b110000) && (tileType & 0b001111) != 1 ? tileType - 1 : NONE;
 }
 
+// suit shapes are keyed in base 5 by the counts of numbers 1-9 (first number lowest)
+const int SUIT_SHAPES = 1953125; // 5^9
+const int POW5[9] = {1, 5, 25, 125, 625, 3125, 15625, 78125, 390625};
+
+// marks shapes made of the given groups plus up to 4 - groupCount more (triplets are kinds 0-8, runs 9-15), with and without one pair
+// states are stored as state + 1 so zeroed entries mean neither (see blockState)
+void markSuitShapes(std::array<uint8_t, SUIT_SHAPES / 4 + 1>& suitStates, uint8_t counts[9], int key, int groupCount, int kind) {
+    suitStates[key >> 2] |= 1 << ((key & 3) << 1);
+    for (int i = 0; i < 9; ++i) {
+        if (counts[i] > 2) continue;
+        int pairKey = key + 2 * POW5[i];
+        suitStates[pairKey >> 2] |= 2 << ((pairKey & 3) << 1);
+    }
+    if (groupCount == 4) return;
+    for (; kind < 16; ++kind) {
+        int first = kind < 9 ? kind : kind - 9;
+        int step = kind < 9 ? 0 : 1;
+        int groupKey = key;
+        bool fits = true;
+        for (int j = 0; j < 3; ++j) {
+            fits &= ++counts[first + j * step] <= 4;
+            groupKey += POW5[first + j * step];
+        }
+        if (fits) markSuitShapes(suitStates, counts, groupKey, groupCount + 1, kind);
+        for (int j = 0; j < 3; ++j) --counts[first + j * step];
+    }
+}
+
+const std::array<uint8_t, SUIT_SHAPES / 4 + 1> initSuitStates() {
+    std::array<uint8_t, SUIT_SHAPES / 4 + 1> suitStates = {};
+    uint8_t counts[9] = {};
+    markSuitShapes(suitStates, counts, 0, 0, 0);
+    return suitStates;
+}
+
+// decomposition state of every suit shape, 2 bits per shape (4 shapes per byte)
+const std::array<uint8_t, SUIT_SHAPES / 4 + 1> SUIT_STATES = initSuitStates();
+
+// base 5 key of a suit's counts (suit 0-2)
+inline int suitKey(const uint8_t counts[TILE_TYPES], int suit) {
+    const uint8_t* suitCounts = counts + 7 + suit * 9;
+    int key = 0;
+    for (int i = 8; i >= 0; --i) key = key * 5 + suitCounts[i];
+    return key;
+}
+
+// decomposition state of a suit shape key
+inline int8_t suitState(int key) {
+    return ((SUIT_STATES[key >> 2] >> ((key & 3) << 1)) & 0b11) - 1;
+}
+
+// decomposition state of a suit (blockIndex 0-2) or the honors (blockIndex 3)
+// 0 = groups only, 1 = groups and one pair, -1 = neither
+inline int8_t blockState(const uint8_t counts[TILE_TYPES], int blockIndex) {
+    if (blockIndex != 3) return suitState(suitKey(counts, blockIndex));
+    int8_t pairs = 0;
+    for (int i = 0; i < 7; ++i) {
+        if (counts[i] == 1 || counts[i] == 4) return -1;
+        pairs += counts[i] == 2;
+    }
+    return pairs <= 1 ? pairs : -1;
+}
+
+// block of type index (honors are block 3)
+inline int typeBlock(int typeIndex) {
+    return typeIndex < 7 ? 3 : (typeIndex - 7) / 9;
+}
+
+// type indices of terminals and honors (the 13 orphans)
+const uint64_t TERMINAL_MASK = 0b1111111ull | (1ull << 7) | (1ull << 15) | (1ull << 16) | (1ull << 24) | (1ull << 25) | (1ull << 33);
+
+// whether closed counts form 7 pairs or 13 orphans (only with exactly 14 tiles)
+inline bool specialComplete(const uint8_t counts[TILE_TYPES]) {
+    const int terminals[13] = {0, 1, 2, 3, 4, 5, 6, 7, 15, 16, 24, 25, 33};
+    int total = 0;
+    int pairs = 0;
+    for (int i = 0; i < TILE_TYPES; ++i) {
+        total += counts[i];
+        pairs += counts[i] == 2;
+    }
+    if (total != 14) return false;
+    if (pairs == 7) return true;
+    int terminalTypes = 0;
+    int terminalTiles = 0;
+    for (int i : terminals) {
+        terminalTypes += counts[i] != 0;
+        terminalTiles += counts[i];
+    }
+    return terminalTypes == 13 && terminalTiles == 14;
+}
+
+bool isComplete(const uint8_t counts[TILE_TYPES]) {
+    int pairBlocks = 0;
+    bool complete = true;
+    for (int b = 0; complete && b < 4; ++b) {
+        int8_t state = blockState(counts, b);
+        complete = state != -1;
+        pairBlocks += state == 1;
+    }
+    return (complete && pairBlocks == 1) || specialComplete(counts);
+}
+
+uint64_t waitMask(uint8_t counts[TILE_TYPES]) {
+    // only tiles held or adjacent to a held suited tile can complete a regular hand
+    uint64_t held = 0;
+    for (int i = 0; i < TILE_TYPES; ++i)
+        held |= (uint64_t)(counts[i] != 0) << i;
+    const uint64_t suitMask = 0b111111111ull;
+    uint64_t candidates = held;
+    for (int suit = 0; suit < 3; ++suit) {
+        uint64_t suitHeld = (held >> (7 + suit * 9)) & suitMask;
+        candidates |= (((suitHeld << 1) | (suitHeld >> 1) | (suitHeld << 2) | (suitHeld >> 2)) & suitMask) << (7 + suit * 9);
+    }
+
+    // adding a tile only changes the state of its own block (a suit's key grows by the tile's power of 5)
+    int8_t states[4];
+    int keys[3];
+    int badBlocks = 0;
+    int pairBlocks = 0;
+    for (int b = 0; b < 4; ++b) {
+        if (b < 3) keys[b] = suitKey(counts, b);
+        states[b] = b < 3 ? suitState(keys[b]) : blockState(counts, b);
+        badBlocks += states[b] == -1;
+        pairBlocks += states[b] == 1;
+    }
+
+    uint64_t waits = 0;
+    if (badBlocks <= 1) {
+        for (int i = 0; i < TILE_TYPES; ++i) {
+            if (!((candidates >> i) & 1) || counts[i] >= 4) continue;
+            int b = typeBlock(i);
+            if (badBlocks && states[b] != -1) continue;
+            int8_t state;
+            if (b < 3) {
+                state = suitState(keys[b] + POW5[(i - 7) % 9]);
+            } else {
+                ++counts[i];
+                state = blockState(counts, b);
+                --counts[i];
+            }
+            if (state != -1 && pairBlocks - (states[b] == 1) + (state == 1) == 1)
+                waits |= 1ull << i;
+        }
+    }
+
+    // 7 pairs / 13 orphans waits (any terminal or honor may complete 13 orphans)
+    int total = 0;
+    int pairs = 0;
+    int terminalTiles = 0;
+    for (int i = 0; i < TILE_TYPES; ++i) {
+        total += counts[i];
+        pairs += counts[i] == 2;
+        terminalTiles += ((TERMINAL_MASK >> i) & 1) * counts[i];
+    }
+    if (total != 13 || (pairs != 6 && terminalTiles != 13)) return waits;
+    uint64_t special = (held | TERMINAL_MASK) & ~waits;
+    for (int i = 0; i < TILE_TYPES; ++i) {
+        if (!((special >> i) & 1) || counts[i] >= 4) continue;
+        ++counts[i];
+        if (specialComplete(counts)) waits |= 1ull << i;
+        --counts[i];
+    }
+    return waits;
+}
+
+void sortHands(const Hand* hands, SortedHand* sortedHands, size_t count) {
+    for (size_t i = 0; i < count; ++i)
+        sortedHands[i].assign(hands[i]);
+}
+
 // returns whether tile is terminal
 inline bool isSimple(TileType tileType) {
     return !(tileType & 0b110000) == 0 && (tileType & 0b001111) != 1 && (tileType & 0b001111) != 9;
 }
 
 // calculate basic points from han and fu
-int ScoreInfo::basicPoints() {
+int ScoreInfo::basicPoints() const {
     if (han == 0) return 0;
     if (han >= DOUBLE_YAKUMAN_HAN) return 16000; // double yakuman
     if (han >= 13) return 8000; // yakuman
@@ -127,39 +410,34 @@ int ScoreInfo::basicPoints() {
     return (((fu * (1 << (2 + han))) + 99) / 100) * 100; // basic points
 }
 
-// add points from tile bonuses (dora, uradora, red fives, wind bonus) (yaku han and fu passed in via han and fu args)
-void tilePoints(const Board& board, int8_t playerIndex, SortedHand& sortedHand, ScoreInfo& scoreInfo) {
-    const Player& player = board.players[playerIndex];
-    const Hand& hand = player.hand;
-    
-    // identify dora
-    int doraTiles[MAX_DORA_INDICATORS << 1];
-    int doraTilesCount = 0;
-    for (int i = 0; i < board.revealedDora; ++i) {
-        doraTiles[doraTilesCount++] = board.getDora(i, false);
-        if (player.riichiTurn) doraTiles[doraTilesCount++] = (1 << 16) | board.getDora(i, true);
-    }
+// dot product of a count vector with a dora table (vectorizable)
+inline int doraDot(const uint8_t counts[TILE_TYPES], const uint8_t table[TILE_TYPES]) {
+    int dora = 0;
+    for (int i = 0; i < TILE_TYPES; ++i)
+        dora += counts[i] * table[i];
+    return dora;
+}
 
-    // iterate through tiles
-    for (int i = 0; i < sortedHand.size(); ++i) {
-        const Tile& tile = hand.tiles[*sortedHand[i]];
-        TileType tileType = *tile;
+// add points from tile bonuses (dora, uradora, red fives)
+template <typename Rules>
+void tilePoints(const BasicBoard<Rules>& board, const Player& player, ScoreInfo& scoreInfo) {
+    const Hand& hand = player.hand;
 
-        // red
-        if (tile.isRed()) scoreInfo.addRedDora();
+    // red fives
+    if constexpr (Rules::RED_FIVES > 0)
+        for (int i = 0; i < MAX_HAND_SIZE; ++i)
+            if (hand.tiles[i].isRed()) scoreInfo.addRedDora();
 
-        // dora
-        for (int j = 0; j < doraTilesCount; ++j)
-            if (tileType == doraTiles[j] & (0xffff))
-                doraTiles[j] & (1 << 16) ? scoreInfo.addUradora() : scoreInfo.addDora();
-    }
+    // dora / uradora
+    scoreInfo.addDora(doraDot(hand.counts, board.doraCounts) + doraDot(hand.callCounts, board.doraCounts));
+    if (player.riichiTurn)
+        scoreInfo.addUradora(doraDot(hand.counts, board.uradoraCounts) + doraDot(hand.callCounts, board.uradoraCounts));
 }
 
-// add points from non-group yaku (group han and fu passed in via yakuHan and yakuFu args)
+// add points from non-group yaku (the same for every decomposition, so scored once per hand)
 // called with special hands such as 13 orphans and 7 pairs
-void yakuPoints(const Board& board, int8_t playerIndex, SortedHand& sortedHand, ScoreInfo& scoreInfo) {
-    const Player& player = board.players[playerIndex];
-    const Hand& hand = player.hand;
+template <typename Rules>
+void yakuPoints(const BasicBoard<Rules>& board, const Player& player, SortedHand& sortedHand, ScoreInfo& scoreInfo) {
 
     // ready / riichi
     // double ready / double riichi
@@ -170,11 +448,11 @@ void yakuPoints(const Board& board, int8_t playerIndex, SortedHand& sortedHand,
             scoreInfo.addYaku(Riichi, 1);
     }
 
-    // all simples / tan'yao
+    // all simples / tan'yao (closed hands only without kuitan)
     {
-        bool tanyao = true;
-        for (int i = 0; tanyao && i < sortedHand.size(); ++i) {
-            TileType tileType = sortedHand[i].type;
+        bool tanyao = Rules::OPEN_TANYAO || player.hand.callMeldCount == 0;
+        for (int i = 0; tanyao && i < sortedHand.size() + player.hand.callTiles; ++i) {
+            TileType tileType = i < sortedHand.size() ? sortedHand[i].type : player.hand[i - sortedHand.size()]; // sorted hand leaves out call tiles
             tanyao = (tileType & 0b110000) != 0 && (tileType & 0b001111) != 1 && (tileType & 0b001111) != 9;
         }
         if (tanyao) scoreInfo.addYaku(AllSimples, 1);
@@ -193,8 +471,8 @@ void yakuPoints(const Board& board, int8_t playerIndex, SortedHand& sortedHand,
         bool allHonors = true;
         bool allTerminals = true;
         bool allGreen = true;
-        for (int i = 0; i < sortedHand.size(); ++i) {
-            TileType tileType = sortedHand[i].type;
+        for (int i = 0; i < sortedHand.size() + player.hand.callTiles; ++i) {
+            TileType tileType = i < sortedHand.size() ? sortedHand[i].type : player.hand[i - sortedHand.size()];
             bool isHonor = (tileType >> 4) == 0;
             bool isTerminal = (tileType >> 4) != 0 && ((tileType & 0b1111) == 1 || (tileType & 0b1111) == 9);
             commonTerminals &= isHonor | isTerminal;
@@ -210,6 +488,43 @@ void yakuPoints(const Board& board, int8_t playerIndex, SortedHand& sortedHand,
         if (allGreen) scoreInfo.addYaku(AllGreen, YAKUMAN_HAN);
     }
 
+    // dragon and wind yaku only depend on tile counts (call tiles included)
+    {
+        int dragons[3] = {};
+        int winds[4] = {};
+        for (int i = 0; i < sortedHand.size() + player.hand.callTiles; ++i) {
+            TileType tileType = i < sortedHand.size() ? sortedHand[i].type : player.hand[i - sortedHand.size()];
+            if ((tileType & 0b111100) == 0b000000)
+                ++dragons[(tileType & 0b11) - 1]; // dragons are 1-3
+            else if ((tileType & 0b111100) == 0b000100)
+                ++winds[tileType & 0b11];
+        }
+
+        // little three dragons
+        // big three dragons
+        std::sort(dragons, dragons + 3);
+        if (dragons[1] >= 3) {
+            if (dragons[0] >= 3) scoreInfo.addYaku(BigThreeDragons, YAKUMAN_HAN);
+            else if (dragons[0] == 2) scoreInfo.addYaku(LittleThreeDragons, 2);
+        }
+
+        // little winds / shosushi
+        // big winds / daisushi
+        std::sort(winds, winds + 4);
+        if (winds[1] >= 3) {
+            if (winds[0] >= 3) scoreInfo.addYaku(BigFourWinds, Rules::DOUBLE_YAKUMAN ? DOUBLE_YAKUMAN_HAN : YAKUMAN_HAN);
+            else if (winds[0] == 2) scoreInfo.addYaku(LittleFourWinds, YAKUMAN_HAN);
+        }
+    }
+
+    // TODO: nine gates / churen poto
+
+    // TODO: blessing of heaven
+
+    // TODO: blessing of earth
+
+    // TODO: blessing of man
+
     // TODO: nagashi mangan
 
     // one shot / ippatsu
@@ -223,285 +538,412 @@ void yakuPoints(const Board& board, int8_t playerIndex, SortedHand& sortedHand,
     // TODO: dead wall draw / after a quad / after a kan
 
     // TODO: robbing a quad / robbing a kan
+}
 
-    // return if hand incomplete
+// add self pick and tile bonuses (tileInfo filled by tilePoints), only once the hand has yaku
+void bonusPoints(const Player& player, ScoreInfo& scoreInfo, const ScoreInfo& tileInfo) {
+    // self pick / tsumo (closed hands only, a yaku on its own)
+    if (!player.ronActive && player.hand.callMeldCount == 0)
+        scoreInfo.addYaku(Tsumo, 1);
+
+    // return if hand has no yaku (dora alone do not win)
     if (scoreInfo.han == 0) return;
 
-    // self pick / tsumo
-    if (!player.ronActive && hand.callMeldCount)
-        scoreInfo.addYaku(Tsumo, 1);
+    scoreInfo.addDora(tileInfo.doraCount);
+    scoreInfo.addUradora(tileInfo.uradoraCount);
+    scoreInfo.addRedDora(tileInfo.redDoraCount);
+}
 
-    tilePoints(board, playerIndex, sortedHand, scoreInfo);
+// fu of a single group (pairs of valued honors and sets, runs give none)
+template <typename Rules>
+int groupFu(const BasicBoard<Rules>& board, const Player& player, const Group& group) {
+    const Hand& hand = player.hand;
+    TileType tileType = hand[group[0]];
+    if (tileType != hand[group[1]]) return 0;
+    if (group.size() == 2) {
+        int fu = 0;
+        fu += ((tileType & 0b111100) == 0b000100) && ((tileType & 0b000011) == board.roundWind) ? 2 : 0; // matches round wind
+        fu += ((tileType & 0b111100) == 0b000100) && ((tileType & 0b000011) == player.seatWind) ? 2 : 0; // matches seat wind
+        fu += (tileType & 0b111100) == 0b000000 ? 2 : 0; // dragon
+        return fu;
+    }
+    int fuPower = ((group.size() - 2) << 1) + !group.open() + !isSimple(tileType);
+    return 1 << fuPower;
 }
 
-// group set points
-// note: groupset not modified (need non-const becuase of [])
-void groupSetPoints(const Board& board, int8_t playerIndex, SortedHand& sortedHand, ScoreInfo& scoreInfo, GroupSet& groupSet) {
-    const Player& player = board.players[playerIndex];
+// fu that does not depend on the decomposition, assuming the tsumo / open pinfu bonus and a 2 fu wait apply
+int fixedFu(const Player& player) {
     const Hand& hand = player.hand;
-    int& fu = scoreInfo.fu;
-    fu = player.ronActive ? 30 : 20;
+    int fu = player.ronActive ? 30 : 20;
+    fu += hand.callMeldCount == 0 && player.ronActive ? 10 : 0;
+    return fu + 2 + 2;
+}
 
-    // find pair
-    int8_t pairIndex;
-    for (pairIndex = 0; groupSet[pairIndex].size() != 2; ++pairIndex);
+const uint64_t HONOR_TYPES = 0x7f; // type indices of honors
+const uint64_t ORPHAN_TYPES = HONOR_TYPES | 1ull << 7 | 1ull << 15 | 1ull << 16 | 1ull << 24 | 1ull << 25 | 1ull << 33; // honors and terminals
+const uint32_t END_RUNS = 0b1000001 * (1 | 1 << 7 | 1 << 14); // runs starting on 1 or 7
 
-    // count fu from groups
-    for (int i = 0; i < groupSet.size(); ++i) {
-        Group& group = groupSet[i];
-        if (sortedHand[group[0]].type != sortedHand[group[1]].type) continue;
-        TileType tileType = group[0];
-        if (group.size() == 2) {
-            // pair fu
-            fu += ((tileType & 0b111100) == 0b000100) && ((tileType & 0b000011) == board.roundWind) ? 2 : 0; // matches round wind
-            fu += ((tileType & 0b111100) == 0b000100) && ((tileType & 0b000011) == board.seatWind) ? 2 : 0; // matches prevailing wind
-            fu += (tileType & 0b111100) == 0b000000 ? 2 : 0; // dragon
-            continue;
+// group set as bitboards (runs by start, sets and pairs by type index), so group yaku are mask and popcount tests
+struct GroupSetBits {
+    uint32_t runs = 0; // run starts, bit 7 * suit + start number - 1 (pin, sou, man)
+    uint32_t twinRuns = 0; // run starts present at least twice
+    uint64_t sets = 0; // triplets and quads
+    uint64_t concealedSets = 0; // sets not called from a discard
+    uint64_t quads = 0;
+    uint64_t pairs = 0;
+
+    GroupSetBits(const Hand& hand, GroupSet& groupSet) {
+        for (int i = 0; i < groupSet.size(); ++i) {
+            const Group& group = groupSet[i];
+            TileType tileType = hand[group[0]];
+            if (tileType != hand[group[1]]) {
+                uint32_t run = 1u << (7 * ((tileType >> 4) - 1) + (tileType & 0b1111) - 1);
+                twinRuns |= runs & run;
+                runs |= run;
+                continue;
+            }
+            uint64_t type = 1ull << TYPE_INDEX_MAP[tileType];
+            if (group.size() == 2) {
+                pairs |= type;
+                continue;
+            }
+            sets |= type;
+            if (!group.open()) concealedSets |= type;
+            if (group.size() == 4) quads |= type;
         }
-        int fuPower = ((group.size() - 2) << 1) + !group.open() + !isSimple(tileType);
-        fu += 1 << fuPower;
     }
+};
 
-    // count fu from waits
-    for (int i = 0; i < hand.waitCount; ++i)
-        fu += hand.waits[i].fu;
+// group set points (adds group yaku and group / wait fu on top of the hand's non-group yaku)
+// the same for ron and tsumo, finished by winPoints
+// note: groupset not modified (need non-const becuase of [])
+template <typename Rules>
+void groupSetPoints(const BasicBoard<Rules>& board, const Player& player, ScoreInfo& scoreInfo, GroupSet& groupSet) {
+    const Hand& hand = player.hand;
+    int16_t& fu = scoreInfo.fu;
+    fu = 0;
 
-    // count fu from closed hand ron / menzen-kafu
-    fu += hand.callMeldCount == 0 && player.ronActive ? 10 : 0;
+    // count fu from groups
+    for (int i = 0; i < groupSet.size(); ++i)
+        fu += groupFu(board, player, groupSet[i]);
 
-    // count suit runs and sets
-    int runCounter[3][7];
-    std::memset(runCounter, 0, sizeof(runCounter));
-    for (int i = 0; i < groupSet.size(); ++i) {
-        Group& group = groupSet[i];
-        if (sortedHand[group[0]].type == sortedHand[group[1]].type) continue; // not a run
-        ++runCounter[(sortedHand[group[0]].type >> 4) - 1][((sortedHand[group[0]].type) & 0b1111) - 1];
-    }
-    int suitSetCounter[3][9];
-    std::memset(suitSetCounter, 0, sizeof(suitSetCounter));
-    for (int i = 0; i < groupSet.size(); ++i) {
-        Group& group = groupSet[i];
-        if (group.size() != 3 || sortedHand[group[0]].type != sortedHand[group[1]].type || (sortedHand[group[0]].type & 0b110000) == 0b000000) continue; // not a suit set
-        ++runCounter[(sortedHand[group[0]].type >> 4) - 1][((sortedHand[group[0]].type) & 0b1111) - 1];
+    // count fu from the wait, any closed group holding the winning type (in the drawn slot) may be the one it completed
+    // edge / penchan, middle / kanchan and single / tanki waits are worth 2, unless a sides / ryanmen reading leaves a pinfu hand
+    {
+        TileType winningType = hand[DRAWN_I];
+        bool twoFuWait = false;
+        bool sidesWait = false;
+        for (int i = 0; i < groupSet.size(); ++i) {
+            const Group& group = groupSet[i];
+            if (group.locked()) continue;
+            TileType first = hand[group[0]];
+            TileType last = hand[group[group.size()-1]];
+            if (group.size() == 2) {
+                twoFuWait |= first == winningType;
+            } else if (first != hand[group[1]]) {
+                twoFuWait |= hand[group[1]] == winningType;
+                bool edge = (first == winningType && (first & 0b1111) == 7) || (last == winningType && (last & 0b1111) == 3);
+                twoFuWait |= edge;
+                sidesWait |= (first == winningType || last == winningType) && !edge;
+            }
+        }
+        fu += twoFuWait && !(sidesWait && fu == 0 && hand.callMeldCount == 0) ? 2 : 0;
     }
 
-    // count fu from tsumo
-    fu += !player.ronActive && hand.callMeldCount == 0 && fu > 20 ? 2 : 0;
-
-    // open pinfu / kui-pinfu
-    fu += fu == 20 && hand.callMeldCount != 0 ? 2 : 0;
-
-    // no-points hand / pinfu
-    if (fu == 20 && hand.callMeldCount == 0)
-        scoreInfo.addYaku(Pinfu, 1);
+    GroupSetBits bits(hand, groupSet);
 
     // twin sequences / ipeiko
     // double twin sequences / ryanpeiko
     if (hand.callMeldCount == 0) {
-        int ipeikoCount = 0;
-        for (int suit = 0; suit < 3; ++suit)
-            for (int num = 0; num < 7; ++num)
-                ipeikoCount += runCounter[suit][num] >= 2;
+        int ipeikoCount = std::popcount(bits.twinRuns);
         if (ipeikoCount >= 2) scoreInfo.addYaku(DoubleTwinSequences, 2);
         else if (ipeikoCount == 1) scoreInfo.addYaku(TwinSequences, 1);
     }
 
     // mixed sequences / sanshoku doujun
-    {
-        bool sanshoku = false;
-        for (int num = 0; !sanshoku && num < 7; ++num)
-            sanshoku = runCounter[0][num] && runCounter[1][num] && runCounter[2][num];
-        if (sanshoku) scoreInfo.addYaku(MixedSequences, 1 + (hand.callMeldCount == 0));
-    }
+    if (bits.runs & (bits.runs >> 7) & (bits.runs >> 14) & 0x7f)
+        scoreInfo.addYaku(MixedSequences, 1 + (hand.callMeldCount == 0));
 
-    // full straight / ikkitsuu
+    // full straight / ikkitsuu (runs starting on 1, 4 and 7 of a suit)
     {
-        bool ikkitsuu = 0;
-        for (int suit = 0; !ikkitsuu && suit < 3; ++suit)
-            ikkitsuu = runCounter[suit][0] && runCounter[suit][3] && runCounter[suit][6];
+        const uint32_t straight = 0b1001001;
+        bool ikkitsuu = false;
+        for (int suit = 0; suit < 3; ++suit)
+            ikkitsuu |= ((bits.runs >> (7 * suit)) & straight) == straight;
         if (ikkitsuu) scoreInfo.addYaku(FullStraight, 1 + (hand.callMeldCount == 0));
     }
 
     // all triplets / toitoi
-    {
-        bool toitoi = true;
-        for (int suit = 0; toitoi && suit < 3; ++suit)
-            for (int num = 0; toitoi && num < 7; ++num)
-                toitoi = runCounter[suit][num] == 0;
-        if (toitoi) scoreInfo.addYaku(AllTriplets, 2);
-    }
+    if (bits.runs == 0) scoreInfo.addYaku(AllTriplets, 2);
 
     // three concealed triplets / san'anko
     // four concealed triplets / suanko
     {
-        int concealedSets = 0;
-        for (int i = 0; i < groupSet.size(); ++i)
-            concealedSets += groupSet[i].size() >= 3 && !groupSet[i].open() && sortedHand[groupSet[i][0]].type == sortedHand[groupSet[i][1]].type;
+        int concealedSets = std::popcount(bits.concealedSets);
         if (concealedSets >= 4) scoreInfo.addYaku(FourConcealedTriplets, YAKUMAN_HAN);
         else if (concealedSets == 3) scoreInfo.addYaku(ThreeConcealedTriplets, 2);
     }
 
     // mixed triplets / sanshoku douko
-    {
-        bool sanshoku = false;
-        for (int num = 0; !sanshoku && num < 9; ++num)
-            sanshoku = suitSetCounter[0][num] && suitSetCounter[1][num] && suitSetCounter[2][num];
-        if (sanshoku) scoreInfo.addYaku(ThreeMixedTriplets, 2);
-    }
+    if ((bits.sets >> 7) & (bits.sets >> 16) & (bits.sets >> 25) & 0x1ff)
+        scoreInfo.addYaku(ThreeMixedTriplets, 2);
 
     // three quads / sankatsu
     // four quads / sukantsu
     {
-        int kanCount = 0;
-        for (int i = 0; i < groupSet.size(); ++i)
-            kanCount += groupSet[i].size() == 4;
+        int kanCount = std::popcount(bits.quads);
         if (kanCount == 4) scoreInfo.addYaku(FourKan, YAKUMAN_HAN);
         else if (kanCount == 3) scoreInfo.addYaku(ThreeKan, 2);
     }
 
     // honor tiles / yakuhai
-    bool hasHonors = false;
-    for (int i = 0; i < sortedHand.size(); ++i) {
-        TileType tileType = sortedHand[i].type;
-        hasHonors |= (tileType >> 4) == 0;
-    }
-    if (hasHonors) {
+    // open sets count too, every dragon set is worth 1 and a wind set 1 per matching wind (double wind is 2)
+    if (bits.sets & HONOR_TYPES) {
         int honorCount = 0;
-        for (int i = 0; i < groupSet.size(); ++i) {
-            if (groupSet[i].size() < 3 || groupSet[i].open() || sortedHand[groupSet[i][0]].type != sortedHand[groupSet[i][1]].type)
-                continue;
-            TileType tileType = sortedHand[groupSet[i][0]].type;
-            honorCount += ((tileType & 0b111100) == 0b000100) && ((tileType & 0b000011) == board.roundWind); // matches round wind
-            honorCount += ((tileType & 0b111100) == 0b000100) && ((tileType & 0b000011) == board.seatWind); // matches prevailing wind
-            honorCount += tileType & 0b111100 == 0b000000; // dragon
+        for (uint64_t mask = bits.sets & HONOR_TYPES; mask; mask &= mask - 1) {
+            int typeIndex = std::countr_zero(mask);
+            if (typeIndex < 3) ++honorCount; // dragon
+            else honorCount += (typeIndex - 3 == board.roundWind) + (typeIndex - 3 == player.seatWind);
         }
         if (honorCount) scoreInfo.addYaku(HonorTiles, honorCount);
     }
 
-    // common ends / chanta
-    // pefect ends / junchan
-    {
-        bool ends = true;
-        for (int i = 0; ends && i < groupSet.size(); ++i) {
-            TileType left = sortedHand[groupSet[i][0]].type;
-            TileType right = sortedHand[groupSet[i][groupSet[i].size()-1]].type;
-            ends = ((left >> 4) != 0 && (left & 0b001111) == 1) || ((right >> 4) != 0 && (right & 0b001111) == 9);
-        }
-        if (ends) {
-            if (hasHonors) scoreInfo.addYaku(CommonEnds, 1 + (hand.callMeldCount == 0));
-            else scoreInfo.addYaku(PerfectEnds, 2 + (hand.callMeldCount == 0));
-        }
+    // common ends / chanta (every group holds a terminal or honor)
+    // pefect ends / junchan (every group holds a terminal)
+    if ((bits.runs & ~END_RUNS) == 0 && ((bits.sets | bits.pairs) & ~ORPHAN_TYPES) == 0) {
+        if ((bits.sets | bits.pairs) & HONOR_TYPES) scoreInfo.addYaku(CommonEnds, 1 + (hand.callMeldCount == 0));
+        else scoreInfo.addYaku(PerfectEnds, 2 + (hand.callMeldCount == 0));
     }
+}
 
-    {
-        int dragons[3] = {};
-        int winds[4] = {};
-        for (int i = 0; i < sortedHand.size(); ++i) {
-            TileType tileType = sortedHand[i].type;
-            if ((tileType & 0b111100) == 0b000000)
-                ++dragons[tileType & 0b11];
-            else if ((tileType & 0b111100) == 0b000100)
-                ++winds[tileType & 0b11];
-        }
-
-        // little three dragons
-        // big three dragons
-        std::sort(dragons, dragons + 3);
-        if (dragons[1] >= 3) {
-            if (dragons[0] >= 3) scoreInfo.addYaku(BigThreeDragons, YAKUMAN_HAN);
-            else if (dragons[0] == 2) scoreInfo.addYaku(LittleThreeDragons, 2);
-        }
-
-        // little winds / shosushi
-        // big winds / daisushi
-        std::sort(winds, winds + 4);
-        if (winds[1] >= 3) {
-            if (winds[0] >= 3) scoreInfo.addYaku(BigFourWinds, DOUBLE_YAKUMAN_HAN);
-            else if (winds[0] == 2) scoreInfo.addYaku(LittleFourWinds, YAKUMAN_HAN);
-        }
-    }
+// add fu and yaku depending on how the group set was won (ron or tsumo)
+void winPoints(const Player& player, ScoreInfo& scoreInfo) {
+    const Hand& hand = player.hand;
+    int16_t& fu = scoreInfo.fu;
+    fu += player.ronActive ? 30 : 20;
 
-    // TODO: nine gates / churen poto
+    // count fu from closed hand ron / menzen-kafu
+    fu += hand.callMeldCount == 0 && player.ronActive ? 10 : 0;
 
-    // TODO: blessing of heaven
+    // count fu from tsumo
+    fu += !player.ronActive && hand.callMeldCount == 0 && fu > 20 ? 2 : 0;
 
-    // TODO: blessing of earth
+    // open pinfu / kui-pinfu
+    fu += fu == 20 && hand.callMeldCount != 0 ? 2 : 0;
 
-    // TODO: blessing of man
+    // no-points hand / pinfu
+    if (fu == 20 && hand.callMeldCount == 0)
+        scoreInfo.addYaku(Pinfu, 1);
 
     // round fu up to nearest 10
     fu = ((fu + 9) / 10) * 10;
-    
-    yakuPoints(board, playerIndex, sortedHand, scoreInfo);
 }
 
-// generate all groups sets (sets of non-overlapping groups, call melds are locked)
-void generateGroupSets(std::deque<GroupSet>& groupSets, const Board& board, int8_t playerIndex, SortedHand& sortedHand, const std::vector<Group>& groups, GroupSet& groupSet, int groupIndex, uint32_t usedTiles, bool pairHandled) {
-    if (groupSet.size() == MAX_GROUPS + 1 && pairHandled) {
-        groupSets.push_back(groupSet);
-        return;
+// best group set search, scoring group sets as they are completed
+// branches are pruned once an optimistic han / fu bound cannot beat the best score found so far
+template <typename Rules>
+struct GroupSetSearch {
+    const BasicBoard<Rules>& board;
+    const Player& player; // scored player (may be a scratch copy holding a hypothetical winning tile)
+    SortedHand& sortedHand;
+    ScoreInfo handInfo; // non-group yaku shared by every group set
+    ScoreInfo tileInfo; // dora, uradora and red fives of the hand
+    int bonusHan; // most han tsumo and tile bonuses can add
+    int baseFu; // fu shared by every group set (upper bound)
+    int honorHan; // most han honor sets can add
+    bool closed; // whether hand has no call melds
+    int callKans; // quads among call melds
+    int maxPoints; // bound for the whole hand, search stops once reached
+    ScoreInfo best;
+    int bestPoints = 0;
+
+    GroupSetSearch(const BasicBoard<Rules>& board, const Player& player, SortedHand& sortedHand) : board(board), player(player), sortedHand(sortedHand) {
+        const Hand& hand = player.hand;
+        yakuPoints(board, player, sortedHand, handInfo);
+        tilePoints(board, player, tileInfo);
+        honorHan = 0;
+        for (int i = 0; i < 7; ++i) {
+            TileType tileType = INDEX_TYPE_MAP[i];
+            if (hand.counts[i] + hand.callCounts[i] < 3) continue;
+            honorHan += ((tileType & 0b000011) == board.roundWind) + ((tileType & 0b000011) == player.seatWind) + 1;
+        }
+        closed = hand.callMeldCount == 0;
+        callKans = 0;
+        for (int i = 0; i < hand.callMeldCount; ++i)
+            callKans += hand.callMelds[i].size() == 4;
+
+        // yakuman cap (group yaku cannot reach double yakuman on their own)
+        ScoreInfo capInfo;
+        capInfo.han = std::max<int>(handInfo.han, YAKUMAN_HAN);
+        maxPoints = capInfo.basicPoints();
+        begin();
+    }
+
+    // resets the search for the player's current win (ron or tsumo)
+    void begin() {
+        bonusHan = tileInfo.han + (!player.ronActive && closed);
+        baseFu = fixedFu(player);
+        best = ScoreInfo();
+        bestPoints = 0;
+    }
+
+    // most points a group set can reach given the groups chosen so far
+    int bound(int fu, int slots, int runs, int sets, int concealedSets, int quads, bool ends) const {
+        int groupSlots = slots - 1; // one slot goes to the pair
+        ScoreInfo scoreInfo;
+        scoreInfo.fu = ((fu + baseFu + 9) / 10) * 10;
+        scoreInfo.han = handInfo.han + bonusHan + honorHan;
+        scoreInfo.han += closed && sets == 0; // pinfu
+        scoreInfo.han += closed ? 2 : 0; // twin sequences
+        scoreInfo.han += 1 + closed; // mixed sequences or full straight
+        scoreInfo.han += runs == 0 ? 2 : 0; // all triplets
+        scoreInfo.han += concealedSets + groupSlots >= 4 ? YAKUMAN_HAN : concealedSets + groupSlots >= 3 ? 2 : 0; // concealed triplets
+        scoreInfo.han += sets + groupSlots >= 3 ? 2 : 0; // mixed triplets
+        scoreInfo.han += quads >= 4 ? YAKUMAN_HAN : quads >= 3 ? 2 : 0; // quads
+        scoreInfo.han += ends ? 2 + closed : 0; // ends
+        return scoreInfo.basicPoints();
+    }
+
+    // scores a complete group set, returns whether the search can stop
+    bool evaluate(GroupSet& groupSet) {
+        ScoreInfo scoreInfo = handInfo;
+        groupSetPoints(board, player, scoreInfo, groupSet);
+        return finish(scoreInfo);
+    }
+
+    // finishes a group set scored by groupSetPoints for the current win, returns whether the search can stop
+    bool finish(ScoreInfo scoreInfo) {
+        winPoints(player, scoreInfo);
+        bonusPoints(player, scoreInfo, tileInfo);
+        int points = scoreInfo.basicPoints();
+        if (points > bestPoints) {
+            bestPoints = points;
+            best = scoreInfo;
+        }
+        return bestPoints >= maxPoints;
+    }
+};
+
+// per-group data used by the search bound
+struct GroupStats {
+    int8_t fu = 0;
+    bool run = false;
+    bool ends = false;
+    GroupStats() {}
+    template <typename Rules>
+    GroupStats(const BasicBoard<Rules>& board, const Player& player, const Group& group) {
+        const Hand& hand = player.hand;
+        fu = groupFu(board, player, group);
+        run = hand[group[0]] != hand[group[1]];
+        TileType left = hand[group[0]];
+        TileType right = hand[group[group.size()-1]];
+        ends = (left >> 4) == 0 || (left & 0b001111) == 1 || (right & 0b001111) == 9; // honor, or terminal at either end
     }
-    for (; groupIndex < groups.size(); ++groupIndex) {
-        const Group& group = groups[groupIndex];
-        uint32_t groupMask = group.mask();
-        if ((usedTiles & groupMask) || (pairHandled && group.size() == 2)) continue;
-        groupSet.push(group);
-        generateGroupSets(groupSets, board, playerIndex, sortedHand, groups, groupSet, groupIndex+1, usedTiles | groupMask, pairHandled || group.size() == 2);
+};
+
+// closed group the search can choose
+struct CandidateGroup {
+    Group group;
+    int8_t positions[4]; // sorted hand positions of group tiles (ascending)
+    uint32_t positionMask; // sorted hand positions used by the group
+    uint32_t lowerMask; // earlier positions of the same types, must be used first (copies of a tile are interchangeable)
+    GroupStats stats;
+};
+
+// depth first search over non-overlapping groups (call melds are locked), returns whether search can stop
+// the lowest unused sorted position must be covered next, so only exact covers of the closed tiles are visited
+template <typename Rules>
+bool searchGroupSet(GroupSetSearch<Rules>& search, const std::vector<CandidateGroup>& candidates, const int16_t* positionStart, const int8_t* suffixFu, GroupSet& groupSet, uint32_t usedPositions, bool pairHandled, int fu, int runs, int sets, int concealedSets, int quads, bool ends) {
+    int slots = MAX_GROUPS + 1 - groupSet.size();
+    if (slots == 0)
+        return pairHandled && search.evaluate(groupSet);
+
+    int position = std::countr_one(usedPositions);
+    if (position >= search.sortedHand.size()) return false;
+
+    // prune if even the best remaining groups cannot beat the best group set
+    if (search.bound(fu + slots * suffixFu[position], slots + pairHandled, runs, sets, concealedSets, quads, ends) <= search.bestPoints)
+        return false;
+
+    for (int i = positionStart[position]; i < positionStart[position+1]; ++i) {
+        const CandidateGroup& candidate = candidates[i];
+        const GroupStats& stats = candidate.stats;
+        int8_t size = candidate.group.size();
+        if ((usedPositions & candidate.positionMask) || (~usedPositions & candidate.lowerMask) || (pairHandled && size == 2)) continue;
+        bool set = size >= 3 && !stats.run;
+        groupSet.push(candidate.group);
+        bool done = searchGroupSet(search, candidates, positionStart, suffixFu, groupSet, usedPositions | candidate.positionMask, pairHandled || size == 2,
+            fu + stats.fu, runs + stats.run, sets + set, concealedSets + set, quads + (size == 4), ends && stats.ends);
         groupSet.pop();
+        if (done) return true;
     }
+    return false;
 }
 
 // handles scoring hands that do not follow standard 4 groups 1 pair (7 pairs, 13 orphans)
-void specialPoints(const Board& board, int8_t playerIndex, SortedHand& sortedHand, ScoreInfo& scoreInfo) {
-    if (board.players[playerIndex].hand.callMeldCount || sortedHand.size() != 14) return;
-    
-    // 7 pairs / chiitoitsu
+template <typename Rules>
+void specialPoints(const BasicBoard<Rules>& board, const Player& player, SortedHand& sortedHand, ScoreInfo& scoreInfo, const ScoreInfo& tileInfo) {
+    if (player.hand.callMeldCount || sortedHand.size() != 14) return;
+
+    // 7 pairs / chiitoitsu (pairs of distinct types)
     {
-        int pairs;
-        for (pairs = 0; pairs < 7 && sortedHand[pairs * 2].type == sortedHand[pairs * 2 + 1].type; ++pairs)
-        if (pairs == 7) {
+        bool sevenPairs = true;
+        for (int i = 0; sevenPairs && i < 7; ++i)
+            sevenPairs = sortedHand[i * 2].type == sortedHand[i * 2 + 1].type && (i == 0 || sortedHand[i * 2].type != sortedHand[i * 2 - 1].type);
+        if (sevenPairs) {
             scoreInfo.addYaku(SevenPairs, 2);
             scoreInfo.fu = 25;
-            yakuPoints(board, playerIndex, sortedHand, scoreInfo);
+            yakuPoints(board, player, sortedHand, scoreInfo);
+            bonusPoints(player, scoreInfo, tileInfo);
             return;
         }
     }
 
-    // 13 orphans / kokushi musou
+    // 13 orphans / kokushi musou (only terminals and honors with a single pair, so every one of the 13 types)
     // TODO: handle 13 wait variant
     {
+        bool orphans = true;
         int pairs = 0;
-        for (int i = 1; i < 14 && pairs <= 1; ++i) pairs += sortedHand[i-1].type == sortedHand[i].type;
-        if (pairs <= 1) {
+        for (int i = 0; i < 14; ++i) {
+            TileType tileType = sortedHand[i].type;
+            orphans &= (tileType >> 4) == 0 || (tileType & 0b1111) == 1 || (tileType & 0b1111) == 9;
+            if (i) pairs += sortedHand[i-1].type == tileType;
+        }
+        if (orphans && pairs == 1) {
             scoreInfo.addYaku(ThirteenOrphans, YAKUMAN_HAN);
-            yakuPoints(board, playerIndex, sortedHand, scoreInfo);
+            yakuPoints(board, player, sortedHand, scoreInfo);
+            bonusPoints(player, scoreInfo, tileInfo);
             return;
         }
     }
 }
 
-// find value of hand
-ScoreInfo Board::valueOfHand(int8_t playerIndex) const {
-    const Player& player = players[playerIndex];
-    const Hand& hand = player.hand;
-    std::vector<Group> groups; // set of all valid groups (may overlap)
-    SortedHand sortedHand(hand);
-
-    // TODO: check if no-tenpai due to discards
-
-    // put all call melds into groups
-    for (int i = 0; i < hand.callMeldCount; ++i) {
-        groups.push_back(hand.callMelds[i]);
-    }
+// find all valid groups by scanning sorted hand (sorted by position, positionStart indexes the first group starting at each sorted position)
+template <typename Rules>
+void findCandidates(const BasicBoard<Rules>& board, const Player& player, SortedHand& sortedHand, std::vector<CandidateGroup>& candidates, int16_t* positionStart) {
+    auto addGroup = [&](int8_t size, const int8_t* positions) {
+        CandidateGroup& candidate = candidates.emplace_back();
+        candidate.group = Group(size);
+        candidate.positionMask = 0;
+        candidate.lowerMask = 0;
+        for (int j = 0; j < size; ++j) {
+            candidate.group[j] = *sortedHand[positions[j]];
+            candidate.positions[j] = positions[j];
+            candidate.positionMask |= 1 << positions[j];
+            for (int k = positions[j] - 1; k >= 0 && sortedHand[k].type == sortedHand[positions[j]].type; --k)
+                candidate.lowerMask |= 1 << k;
+        }
+        candidate.lowerMask &= ~candidate.positionMask;
+        candidate.stats = GroupStats(board, player, candidate.group);
+    };
 
     // find all valid set groups
     auto findSets = [&](int8_t setSize) {
-        for (int i = hand.callTiles; i <= sortedHand.size()-setSize; ++i) {
+        for (int8_t i = 0; i <= sortedHand.size()-setSize; ++i) {
             if (sortedHand[i].type != sortedHand[i+setSize-1].type)
                 continue;
-            groups.emplace_back(setSize);
-            for (int j = 0; j < setSize; ++j)
-                groups.back()[j] = *sortedHand[i+j];
+            int8_t positions[4] = {i, (int8_t)(i+1), (int8_t)(i+2), (int8_t)(i+3)};
+            addGroup(setSize, positions);
         }
     };
     findSets(2);
@@ -509,116 +951,832 @@ ScoreInfo Board::valueOfHand(int8_t playerIndex) const {
     findSets(4);
 
     // find all valid run groups
-    for (int i = hand.callTiles; i <= sortedHand.size()-3; ++i) {
+    for (int8_t i = 0; i <= sortedHand.size()-3; ++i) {
         TileType middle = nextInRun(sortedHand[i].type);
         TileType last = nextInRun(middle);
         if (last == NONE) continue; // since nextInRun(NONE) = NONE, checking last is sufficient
-        for (int j = sortedHand[i].nextTypeIndice; j < sortedHand.size() && sortedHand[j].type == middle; ++j) {
-            for (int k = sortedHand[j].nextTypeIndice; k < sortedHand.size() && sortedHand[k].type == last; ++k) {
-                groups.emplace_back(3, false);
-                groups.back()[0] = *sortedHand[i];
-                groups.back()[1] = *sortedHand[j];
-                groups.back()[2] = *sortedHand[k];
+        for (int8_t j = sortedHand[i].nextTypeIndice; j < sortedHand.size() && sortedHand[j].type == middle; ++j) {
+            for (int8_t k = sortedHand[j].nextTypeIndice; k < sortedHand.size() && sortedHand[k].type == last; ++k) {
+                int8_t positions[3] = {i, j, k};
+                addGroup(3, positions);
             }
         }
     }
 
-    // sort groups (should keep call melds at front)
-    sort(groups.begin(), groups.end(), [](Group& a, Group& b) {
-        int cap = std::min(a.size(), b.size());
+    // sort groups by sorted positions
+    sort(candidates.begin(), candidates.end(), [](CandidateGroup& a, CandidateGroup& b) {
+        int cap = std::min(a.group.size(), b.group.size());
         for (int i = 0; i < cap; ++i)
-            if (a[i] != b[i]) return a[i] < b[i];
-        return a.size() < b.size();
+            if (a.positions[i] != b.positions[i]) return a.positions[i] < b.positions[i];
+        return a.group.size() < b.group.size();
     });
 
-    // debug print
-    std::cout << "VALID GROUPS" << std::endl;
-    for (int i = 0; i < groups.size(); ++i) {
-        for (int j = 0; j < groups[i].size(); ++j)
-            std::cout << (int)groups[i][j] << " ";
-        std::cout << std::endl;
+    positionStart[sortedHand.size()] = candidates.size();
+    for (int p = sortedHand.size() - 1, i = candidates.size(); p >= 0; --p) {
+        while (i > 0 && candidates[i-1].positions[0] >= p) --i;
+        positionStart[p] = i;
     }
-    std::cout << groups.size() << std::endl;
+}
+
+// search group sets built from the hand's valid groups
+template <typename Rules>
+void searchGroupSets(GroupSetSearch<Rules>& search, const Hand& hand, SortedHand& sortedHand, GroupSet& groupSet) {
+    static thread_local std::vector<CandidateGroup> candidates; // set of all valid groups (may overlap), reused between calls
+    candidates.clear();
+    int16_t positionStart[MAX_HAND_SIZE + 1];
+    findCandidates(search.board, search.player, sortedHand, candidates, positionStart);
+
+    // suffix maximum of group fu bounds fu of the groups still to be chosen
+    int8_t suffixFu[MAX_HAND_SIZE + 1];
+    suffixFu[sortedHand.size()] = 0;
+    for (int p = sortedHand.size() - 1; p >= 0; --p) {
+        suffixFu[p] = suffixFu[p+1];
+        for (int i = positionStart[p]; i < positionStart[p+1]; ++i)
+            suffixFu[p] = std::max(suffixFu[p], candidates[i].stats.fu);
+    }
+
+    // call melds are already in the group set
+    int fu = 0, runs = 0, sets = 0, concealedSets = 0;
+    bool ends = true;
+    for (int i = 0; i < groupSet.size(); ++i) {
+        GroupStats stats(search.board, search.player, groupSet[i]);
+        bool set = !stats.run;
+        fu += stats.fu;
+        runs += stats.run;
+        sets += set;
+        concealedSets += set && !groupSet[i].open();
+        ends &= stats.ends;
+    }
+    searchGroupSet(search, candidates, positionStart, suffixFu, groupSet, 0, false, fu, runs, sets, concealedSets, search.callKans, ends);
+}
+
+// score the agari table's decompositions of the closed shape (no group search)
+template <typename Rules>
+void tableGroupSets(GroupSetSearch<Rules>& search, const Hand& hand, SortedHand& sortedHand, const GroupSet& baseGroupSet) {
+    AgariShape shape(hand.counts);
+    const AgariRecord* record = AgariTable::find(shape);
+    if (!record) return;
+
+    // first sorted position of each type (tiles of a type are contiguous in sorted hand)
+    int8_t typeStart[TILE_TYPES];
+    for (int i = sortedHand.size() - 1; i >= 0; --i)
+        typeStart[TYPE_INDEX_MAP[sortedHand[i].type]] = i;
+
+    for (int d = 0; d < record->decompositionCount; ++d) {
+        uint32_t decomposition = record->decompositions[d];
+        int8_t taken[MAX_AGARI_POSITIONS] = {};
+        auto take = [&](int8_t position) {
+            return (int8_t)*sortedHand[typeStart[shape.positionTypes[position]] + taken[position]++];
+        };
+
+        GroupSet groupSet = baseGroupSet;
+        Group pair(2);
+        int8_t pairPosition = agariPairPosition(decomposition);
+        pair[0] = take(pairPosition);
+        pair[1] = take(pairPosition);
+        groupSet.push(pair);
+        for (int g = 0; g < shape.groups; ++g) {
+            int8_t position = agariGroupPosition(decomposition, g);
+            bool run = agariGroupRun(decomposition, g);
+            Group group(3);
+            for (int k = 0; k < 3; ++k)
+                group[k] = take(run ? position + k : position);
+            groupSet.push(group);
+        }
+        if (search.evaluate(groupSet)) return;
+    }
+}
+
+// find value of hand
+template <typename Rules>
+ScoreInfo BasicBoard<Rules>::valueOfHand(int8_t playerIndex) const {
+    StageTimer timer(engineStats.countScoring());
+    const Player& player = players[playerIndex];
+    const Hand& hand = player.hand;
+    SortedHand sortedHand(hand);
+    timer.lap(SortStage);
+
+    // furiten hands cannot win by ron
+    if (player.ronActive && player.furiten()) return ScoreInfo();
 
     // setup base group set with call melds
     GroupSet groupSet;
     for (int i = 0; i < hand.callMeldCount; ++i)
-        groupSet.push(groups[i]);
+        groupSet.push(hand.callMelds[i]);
 
-    // get all valid group sets
-    std::deque<GroupSet> groupSets;
-    generateGroupSets(groupSets, *this, playerIndex, sortedHand, groups, groupSet, groupSet.size(), 0, false);
+    // handle group-based yaku scoring (closed shape decompositions come from the agari table when it is loaded)
+    GroupSetSearch search(*this, player, sortedHand);
+    if (AgariTable::loaded())
+        tableGroupSets(search, hand, sortedHand, groupSet);
+    else
+        searchGroupSets(search, hand, sortedHand, groupSet);
+    timer.lap(GroupSetStage);
 
-    // debug print
-    std::cout << "VALID GROUP SETS" << std::endl;
-    for (GroupSet& groupSet : groupSets) {
-        for (int i = 0; i < groupSet.size(); ++i) {
-            std::cout << "(" << (int)groupSet[i][0];
-            for (int j = 1; j < groupSet[i].size(); ++j)
-                std::cout << "," << (int)groupSet[i][j];
-            std::cout << ") ";
-        }
-        std::cout << std::endl;
+    // handle special yaku scoring
+    ScoreInfo specialInfo;
+    specialPoints(*this, player, sortedHand, specialInfo, search.tileInfo);
+    timer.lap(SpecialStage);
+    if (specialInfo.basicPoints() > search.bestPoints)
+        return specialInfo;
+
+    return search.best;
+}
+
+// group set of a hand one tile short of winning, the partial group is completed by the winning tile
+struct PartialGroupSet {
+    GroupSet groupSet; // complete groups (including call melds)
+    Group partial; // hand indices of the incomplete group (one tile waiting on a pair, two waiting on a set or run)
+    uint64_t waits; // type indices completing the partial group
+};
+
+// depth first search over exact covers of the sorted hand that leave exactly one partial group
+void searchPartialGroupSets(std::vector<PartialGroupSet>& partialSets, SortedHand& sortedHand, const std::vector<CandidateGroup>& candidates, const int16_t* positionStart, GroupSet& groupSet, Group& partial, uint64_t waits, uint32_t usedPositions, bool pairHandled) {
+    int position = std::countr_one(usedPositions);
+    if (position >= sortedHand.size()) {
+        if (waits && pairHandled) partialSets.push_back({groupSet, partial, waits});
+        return;
     }
-    
-    // handle group-based yaku scoring
-    int maxPoints = 0;
-    ScoreInfo maxScoreInfo;
-    static ScoreInfo currScoreInfo;
-    for (GroupSet& groupSet : groupSets) {
-        currScoreInfo.clear();
-        groupSetPoints(*this, playerIndex, sortedHand, currScoreInfo, groupSet);
-        int points = currScoreInfo.basicPoints();
-        if (points > maxPoints) {
-            maxPoints = points;
-            maxScoreInfo = currScoreInfo;
-        }
+
+    // complete groups
+    for (int i = positionStart[position]; i < positionStart[position+1]; ++i) {
+        const CandidateGroup& candidate = candidates[i];
+        int8_t size = candidate.group.size();
+        if ((usedPositions & candidate.positionMask) || (~usedPositions & candidate.lowerMask) || (pairHandled && size == 2)) continue;
+        groupSet.push(candidate.group);
+        searchPartialGroupSets(partialSets, sortedHand, candidates, positionStart, groupSet, partial, waits, usedPositions | candidate.positionMask, pairHandled || size == 2);
+        groupSet.pop();
+    }
+    if (waits) return;
+
+    // single tile waiting on its pair / tanki
+    TileType tileType = sortedHand[position].type;
+    if (!pairHandled) {
+        partial = Group(1);
+        partial[0] = *sortedHand[position];
+        searchPartialGroupSets(partialSets, sortedHand, candidates, positionStart, groupSet, partial, 1ULL << TYPE_INDEX_MAP[tileType], usedPositions | (1 << position), true);
     }
 
-    // handle special yaku scoring
-    currScoreInfo.clear();
-    specialPoints(*this, playerIndex, sortedHand, currScoreInfo);
-    int points = currScoreInfo.basicPoints();
-    if (points > maxPoints) {
-        maxPoints = points;
-        maxScoreInfo = currScoreInfo;
+    // two tiles waiting on a set or run (first unused copy of the second tile's type)
+    auto searchTwoTiles = [&](TileType otherType, uint64_t otherWaits) {
+        if (otherType == NONE || !otherWaits) return;
+        int8_t other = position + 1;
+        while (other < sortedHand.size() && (sortedHand[other].type < otherType || (usedPositions >> other) & 1)) ++other;
+        if (other >= sortedHand.size() || sortedHand[other].type != otherType) return;
+        partial = Group(2);
+        partial[0] = *sortedHand[position];
+        partial[1] = *sortedHand[other];
+        searchPartialGroupSets(partialSets, sortedHand, candidates, positionStart, groupSet, partial, otherWaits, usedPositions | (1 << position) | (1 << other), pairHandled);
+    };
+    TileType middle = nextInRun(tileType);
+    TileType last = nextInRun(middle);
+    bool hasPrevious = (tileType & 0b110000) && (tileType & 0b001111) > 1;
+    searchTwoTiles(tileType, 1ULL << TYPE_INDEX_MAP[tileType]); // pair waiting on a set / shanpon
+    if (middle != NONE) // sides / ryanmen, edge / penchan
+        searchTwoTiles(middle, (hasPrevious ? 1ULL << TYPE_INDEX_MAP[tileType - 1] : 0) | (last != NONE ? 1ULL << TYPE_INDEX_MAP[last] : 0));
+    if (last != NONE) // middle / kanchan
+        searchTwoTiles(last, 1ULL << TYPE_INDEX_MAP[middle]);
+}
+
+// completes a partial group with the winning tile in the drawn slot (run tiles are ordered by type)
+Group completeGroup(const Hand& hand, const Group& partial) {
+    Group group(partial.size() + 1);
+    for (int i = 0; i < partial.size(); ++i)
+        group[i] = partial[i];
+    group[partial.size()] = DRAWN_I;
+    for (int i = group.size() - 1; i > 0 && hand[group[i]] < hand[group[i-1]]; --i)
+        std::swap(group[i], group[i-1]);
+    return group;
+}
+
+// find value of every winning tile of a 13 tile hand (drawn slot empty)
+// the hand is decomposed once into group sets with one partial group, each winning tile only completes and scores them
+template <typename Rules>
+void BasicBoard<Rules>::valueOfWaits(int8_t playerIndex, WaitScores& scores) const {
+    scores.clear();
+    const Hand& baseHand = players[playerIndex].hand;
+    if (baseHand[DRAWN_I] != NONE) return;
+    uint8_t counts[TILE_TYPES];
+    std::memcpy(counts, baseHand.counts, sizeof(counts));
+    uint64_t winningMask = waitMask(counts);
+    if (!winningMask) return;
+
+    // scratch buffers reused between calls
+    static thread_local std::vector<CandidateGroup> candidates;
+    static thread_local std::vector<PartialGroupSet> partialSets;
+    static thread_local std::vector<ScoreInfo> groupInfos;
+    candidates.clear();
+    partialSets.clear();
+
+    // decompose the 13 tiles once
+    SortedHand baseSortedHand(baseHand);
+    int16_t positionStart[MAX_HAND_SIZE + 1];
+    findCandidates(*this, players[playerIndex], baseSortedHand, candidates, positionStart);
+    GroupSet groupSet;
+    for (int i = 0; i < baseHand.callMeldCount; ++i)
+        groupSet.push(baseHand.callMelds[i]);
+    Group partial(1);
+    searchPartialGroupSets(partialSets, baseSortedHand, candidates, positionStart, groupSet, partial, 0, 0, false);
+
+    // winning tiles are placed into the drawn slot of a scratch player
+    Player player = players[playerIndex];
+    Hand& hand = player.hand;
+    bool furiten = player.furiten();
+    for (uint64_t mask = winningMask; mask; mask &= mask - 1) {
+        int8_t typeIndex = std::countr_zero(mask);
+        TileType tileType = INDEX_TYPE_MAP[typeIndex];
+        WaitScore& score = scores.push(tileType);
+        hand.setTile(DRAWN_I, Tile(tileType));
+        SortedHand sortedHand = baseSortedHand;
+        sortedHand.insert(tileType, DRAWN_I);
+
+        // score the group sets completed by the tile once, non-group yaku, group yaku and tile bonuses are shared by ron and tsumo
+        player.ronActive = false;
+        GroupSetSearch search(*this, player, sortedHand);
+        groupInfos.clear();
+        for (const PartialGroupSet& partialSet : partialSets) {
+            if (!((partialSet.waits >> typeIndex) & 1)) continue;
+            GroupSet winningGroupSet = partialSet.groupSet;
+            winningGroupSet.push(completeGroup(hand, partialSet.partial));
+            groupSetPoints(*this, player, groupInfos.emplace_back(search.handInfo), winningGroupSet);
+        }
+
+        for (int ron = 0; ron <= 1; ++ron) {
+            ScoreInfo& scoreInfo = ron ? score.ron : score.tsumo;
+            scoreInfo = ScoreInfo();
+            if (ron && furiten) continue;
+            player.ronActive = ron;
+
+            // handle group-based yaku scoring
+            search.begin();
+            for (const ScoreInfo& groupInfo : groupInfos)
+                if (search.finish(groupInfo)) break;
+            scoreInfo = search.best;
+
+            // handle special yaku scoring
+            ScoreInfo specialInfo;
+            specialPoints(*this, player, sortedHand, specialInfo, search.tileInfo);
+            if (specialInfo.basicPoints() > search.bestPoints)
+                scoreInfo = specialInfo;
+        }
+        hand.discardDrawn();
     }
+}
 
-    return maxScoreInfo;
+// copies of a type index in the wall of a rule set
+template <typename Rules>
+inline int typeCopies(int t) {
+    if constexpr (Rules::MAN_TERMINALS_ONLY)
+        if (t > 25 && t < 33) return 0; // man 2-8
+    return 4;
 }
 
-void Board::initGame() {
-    nextRound();
+// starting wall of a rule set, built once from GAME_TILES (removed types skipped, red fives reassigned)
+template <typename Rules>
+const Tile* ruleTiles() {
+    static_assert(Rules::RED_FIVES <= 8, "red fives must fit in the pin and sou copies");
+    static const std::array<Tile, Rules::TILE_COUNT> tiles = [] {
+        std::array<Tile, Rules::TILE_COUNT> tiles;
+        size_t count = 0;
+        for (const Tile& tile : GAME_TILES) {
+            TileType tileType = *tile;
+            if (Rules::MAN_TERMINALS_ONLY && (tileType >> 4) == 0b11 && (tileType & 0b1111) != 1 && (tileType & 0b1111) != 9) continue;
+            tiles[count++] = Tile(tileType);
+        }
+
+        // red fives go to the last copies, one per suit in the wall then any extra to pin
+        TileType fives[3] = {PIN5, SOU5, MAN5};
+        for (int red = 0, suit = 0; red < Rules::RED_FIVES; ++suit) {
+            TileType five = fives[suit % 3];
+            for (size_t i = count; i-- > 0;) {
+                if (*tiles[i] != five || tiles[i].isRed()) continue;
+                tiles[i] = Tile(five, true);
+                ++red;
+                break;
+            }
+        }
+        return tiles;
+    }();
+    return tiles.data();
+}
+
+template <typename Rules>
+void BasicBoard<Rules>::initGame() {
+    riichiSticks = 0;
     roundWind = 0;
-    seatWind = 0;
+    dealer = 0;
+    dealRound();
 }
 
-void Board::nextRound() {
-    roundWind += seatWind == 0b11;
-    seatWind = (seatWind + 1) & 0b11;
+template <typename Rules>
+void BasicBoard<Rules>::nextRound() {
+    // the round wind moves on once every player has dealt
+    dealer = (dealer + 1) % Rules::PLAYER_COUNT;
+    roundWind += dealer == 0;
+    dealRound();
+}
+
+template <typename Rules>
+void BasicBoard<Rules>::dealRound() {
     turn = 1;
     lastCallTurn = 0;
     lastDrawAction = natural;
     lastDiscardPlayer = -1;
-    revealedDora = 1;
-    memcpy(wall, GAME_TILES, sizeof(GAME_TILES));
-    std::random_shuffle(std::begin(wall), std::end(wall));
-    for (int i = 0; i < PLAYER_COUNT; ++i)
+    kanCount = 0;
+    revealedDora = 0;
+    std::memset(doraCounts, 0, sizeof(doraCounts));
+    std::memset(uradoraCounts, 0, sizeof(uradoraCounts));
+    winner = -1;
+    loser = -1;
+    winScore = ScoreInfo();
+    std::memset(visibleCounts, 0, sizeof(visibleCounts));
+    memcpy(wall, ruleTiles<Rules>(), sizeof(wall));
+    std::shuffle(std::begin(wall), std::end(wall), random);
+    for (int i = 0; i < Rules::PLAYER_COUNT; ++i) {
         players[i].initRound();
+        players[i].seatWind = (i - dealer + Rules::PLAYER_COUNT) % Rules::PLAYER_COUNT;
+        for (int t = 0; t < TILE_TYPES; ++t)
+            unseenCounts[i][t] = typeCopies<Rules>(t);
+    }
+    revealDora();
+    for (int t = 0; t < TILE_TYPES; t += t < 7 ? 1 : 9)
+        updateDanger(t);
+
+    // deal 13 tiles to each player starting from the dealer, then dealer draws
+    drawIndex = Rules::TILE_COUNT - 1;
+    for (int i = 0; i < Rules::PLAYER_COUNT; ++i) {
+        int8_t p = (dealer + i) % Rules::PLAYER_COUNT;
+        for (int j = 0; j < 13; ++j) {
+            --unseenCounts[p][TYPE_INDEX_MAP[*wall[drawIndex]]];
+            players[p].hand.setTile(j, wall[drawIndex--]);
+        }
+        players[p].hand.updateWaits();
+    }
+    currentPlayer = dealer;
+    players[currentPlayer].firstTurn = turn;
+    drawTile(currentPlayer, natural);
+    phase = TurnPhase;
+}
+
+template <typename Rules>
+inline TileType BasicBoard<Rules>::getDora(int index, bool ura) const {
+    TileType dora = DORA_MAP[*wall[DORA_OFFSET + ((index << 1) | ura)]];
+    if constexpr (Rules::MAN_TERMINALS_ONLY)
+        if (dora == MAN2) dora = MAN9; // man 1 indicates man 9
+    return dora;
+}
+
+template <typename Rules>
+void BasicBoard<Rules>::revealDora() {
+    ++doraCounts[TYPE_INDEX_MAP[getDora(revealedDora, false)]];
+    ++uradoraCounts[TYPE_INDEX_MAP[getDora(revealedDora, true)]];
+    reveal(TYPE_INDEX_MAP[*wall[DORA_OFFSET + (revealedDora << 1)]]);
+    ++revealedDora;
 }
 
-inline TileType Board::getDora(int index, bool ura) const {
-    return *wall[DORA_OFFSET + (index << 1) | ura];
+// deal-in chance against a tenpai hand in tenths of a percent (rough figures from riichi deal-in statistics)
+const uint8_t HONOR_DANGER[4] = {60, 30, 12, 3}; // by copies visible
+// suited tiles by distance from the edge (1/9, 2/8, 3/7, 4/6, 5) and ryanmen sides left open (1-3 and 7-9 have one side)
+const uint8_t SUITED_DANGER[5][3] = {
+    {15, 55, 0},
+    {25, 70, 0},
+    {40, 85, 0},
+    {30, 75, 115},
+    {30, 80, 120},
+};
+
+// danger of discarding type index t against a player, from its safe tiles, suji, kabe and discard order
+template <typename Rules>
+uint8_t BasicBoard<Rules>::tileDanger(int8_t playerIndex, int8_t t) const {
+    const Player& player = players[playerIndex];
+    const uint8_t* visible = visibleCounts;
+    int left = typeCopies<Rules>(t) - visible[t];
+    if (((player.safeMask >> t) & 1) || left <= 0) return 0; // genbutsu, or no copy left to wait on
+    if (t < 7) return HONOR_DANGER[visible[t]];
+
+    // a ryanmen side waits on t and its suji, it is closed when the suji is safe or a tile of the shape is gone (kabe)
+    int suit = t - (t - 7) % 9, rank = t - suit;
+    auto safe = [&](int r) { return (player.safeMask >> (suit + r)) & 1; };
+    auto gone = [&](int r) { return visible[suit + r] >= typeCopies<Rules>(suit + r); };
+    int open = 0;
+    if (rank >= 3) open += !safe(rank - 3) && !gone(rank - 2) && !gone(rank - 1);
+    if (rank <= 5) open += !safe(rank + 3) && !gone(rank + 1) && !gone(rank + 2);
+    int danger = SUITED_DANGER[std::min(rank, 8 - rank)][open];
+
+    // matagi suji of the riichi tile are likelier waits, tiles outside an early discard of the suit are less likely
+    int riichiRank = player.riichiTile - suit;
+    if (riichiRank >= 0 && riichiRank < 9 && riichiRank != rank && std::abs(riichiRank - rank) <= 2) danger = danger * 3 / 2;
+    uint32_t early = (player.earlyMask >> suit) & 0x1ff;
+    uint32_t inside = rank < 4 ? (0x1f & ~((2u << rank) - 1)) : rank > 4 ? ((1u << rank) - 1) & ~0xfu : 0; // early ranks between t and 5
+    if (early & inside) danger = danger * 3 / 4;
+    if (left == 1) danger /= 2; // no shanpon on the last copy
+    return std::min(danger, 255);
 }
 
-inline void Board::drawTile(int8_t playerIndex, DrawAction drawAction) {
-    Tile tile = wall[drawIndex--];
+template <typename Rules>
+void BasicBoard<Rules>::reveal(int8_t typeIndex, int8_t owner) {
+    ++visibleCounts[typeIndex];
+    for (int i = 0; i < Rules::PLAYER_COUNT; ++i)
+        unseenCounts[i][typeIndex] -= i != owner;
+    updateDanger(typeIndex);
+}
+
+template <typename Rules>
+void BasicBoard<Rules>::updateDanger(int8_t typeIndex) {
+    int first = typeIndex < 7 ? typeIndex : typeIndex - (typeIndex - 7) % 9;
+    int last = typeIndex < 7 ? typeIndex : first + 8;
+    for (int i = 0; i < Rules::PLAYER_COUNT; ++i)
+        for (int t = first; t <= last; ++t)
+            players[i].danger[t] = tileDanger(i, t);
+}
+
+template <typename Rules>
+inline void BasicBoard<Rules>::drawTile(int8_t playerIndex, DrawAction drawAction) {
+    Tile tile = drawAction == kan ? wall[kanCount - 1] : wall[drawIndex--];
     tile.setLastAction(Tile::Action::Drawn, turn);
     Player& player = players[playerIndex];
-    player.hand.tiles[DRAWN_I] = tile;
+    player.hand.setTile(DRAWN_I, tile);
+    --unseenCounts[playerIndex][TYPE_INDEX_MAP[*tile]];
     lastDrawAction = drawAction;
 }
 
+template <typename Rules>
+int BasicBoard<Rules>::wallRemaining() const {
+    return drawIndex - (int)(DEAD_WALL_SIZE + kanCount) + 1;
+}
+
+template <typename Rules>
+void BasicBoard<Rules>::legalActions(int8_t playerIndex, ActionList& actions) const {
+    actions.clear();
+    if (phase == EndPhase) return;
+    if (phase == TurnPhase ? playerIndex != currentPlayer : !canReact(playerIndex)) return;
+    const Player& player = players[playerIndex];
+    const Hand& hand = player.hand;
+
+    // closed tile counts and hand indices per type (normal tile and red tile separately)
+    uint8_t counts[TILE_TYPES];
+    int8_t typeIndices[TILE_TYPES][4];
+    int8_t redIndex[TILE_TYPES];
+    std::memset(counts, 0, sizeof(counts));
+    std::memset(redIndex, -1, sizeof(redIndex));
+    for (int i = hand.callTiles; i < MAX_HAND_SIZE; ++i) {
+        if (hand[i] == NONE) continue;
+        int8_t t = TYPE_INDEX_MAP[hand[i]];
+        if (hand.tiles[i].isRed()) redIndex[t] = i;
+        typeIndices[t][counts[t]++] = i;
+    }
+
+    // mask of n hand indices of type t, taking the red tile first if useRed, otherwise avoiding it
+    auto typeMask = [&](int8_t t, int n, bool useRed) {
+        uint32_t mask = 0;
+        if (useRed) {
+            mask |= 1 << redIndex[t];
+            --n;
+        }
+        for (int k = 0; n && k < counts[t]; ++k) {
+            if (typeIndices[t][k] == redIndex[t]) continue;
+            mask |= 1 << typeIndices[t][k];
+            --n;
+        }
+        return mask;
+    };
+
+    if (phase == TurnPhase) {
+        bool drew = hand[DRAWN_I] != NONE;
+        bool closedHand = true;
+        for (int m = 0; m < hand.callMeldCount; ++m) closedHand &= !hand.callMelds[m].open();
+
+        // self pick / tsumo (needs a yaku)
+        if (drew && isComplete(counts) && valueOfHand(playerIndex).han > 0)
+            actions.push(Action(Action::Tsumo, playerIndex));
+
+        // kans (need a rinshan tile and a tile to draw after it)
+        if (drew && kanCount < MAX_KANS && wallRemaining() > 0) {
+            if (player.riichiTurn) {
+                // closed kan on drawn tile only if waits are unchanged
+                int8_t t = TYPE_INDEX_MAP[hand[DRAWN_I]];
+                if (counts[t] == 4) {
+                    --counts[t];
+                    uint64_t waits = waitMask(counts);
+                    counts[t] -= 3;
+                    if (waitMask(counts) == waits)
+                        actions.push(Action(Action::ClosedKan, playerIndex, -1, typeMask(t, 4, redIndex[t] != -1)));
+                    counts[t] += 4;
+                }
+            } else {
+                for (int t = 0; t < TILE_TYPES; ++t)
+                    if (counts[t] == 4)
+                        actions.push(Action(Action::ClosedKan, playerIndex, -1, typeMask(t, 4, redIndex[t] != -1)));
+                for (int m = 0; m < hand.callMeldCount; ++m) {
+                    const Group& meld = hand.callMelds[m];
+                    int8_t t = TYPE_INDEX_MAP[hand[meld[0]]];
+                    if (meld.size() == 3 && hand[meld[0]] == hand[meld[1]] && counts[t])
+                        actions.push(Action(Action::AddedKan, playerIndex, typeIndices[t][0]));
+                }
+            }
+        }
+
+        // discards (riichi players must discard drawn tile)
+        if (player.riichiTurn) {
+            actions.push(Action(Action::Discard, playerIndex, DRAWN_I));
+            return;
+        }
+        bool canRiichi = closedHand && drew && player.score >= RIICHI_COST && wallRemaining() >= Rules::PLAYER_COUNT;
+
+        // discarding a tile leaves the other blocks as they are, so a regular wait needs at most one bad block among them
+        // (seven pairs and thirteen orphans waits need 6 paired types or 13 terminal and honor tiles)
+        int8_t states[4];
+        int badBlocks = 0;
+        bool specialShape = false;
+        if (canRiichi) {
+            int pairTypes = 0;
+            int terminalTiles = 0;
+            for (int b = 0; b < 4; ++b) badBlocks += (states[b] = blockState(counts, b)) == -1;
+            for (int t = 0; t < TILE_TYPES; ++t) {
+                pairTypes += counts[t] >= 2;
+                terminalTiles += ((TERMINAL_MASK >> t) & 1) * counts[t];
+            }
+            specialShape = pairTypes >= 6 || terminalTiles >= 13;
+        }
+        uint64_t riichiChecked = 0;
+        uint64_t riichiWaits = 0; // types whose discard leaves a wait
+        uint64_t seen[2] = {};
+        for (int i = MAX_HAND_SIZE - 1; i >= hand.callTiles; --i) {
+            if (hand[i] == NONE) continue;
+            int8_t t = TYPE_INDEX_MAP[hand[i]];
+            bool red = hand.tiles[i].isRed();
+            if (i != DRAWN_I) {
+                // identical tiles are interchangeable (drawn tile kept separate for tsumogiri)
+                if ((seen[red] >> t) & 1) continue;
+                seen[red] |= 1ull << t;
+            }
+            actions.push(Action(Action::Discard, playerIndex, i));
+            if (canRiichi) {
+                if (!((riichiChecked >> t) & 1) && (specialShape || badBlocks - (states[typeBlock(t)] == -1) <= 1)) {
+                    --counts[t];
+                    riichiWaits |= (uint64_t)(waitMask(counts) != 0) << t;
+                    ++counts[t];
+                }
+                riichiChecked |= 1ull << t;
+                if ((riichiWaits >> t) & 1) actions.push(Action(Action::Riichi, playerIndex, i));
+            }
+        }
+        return;
+    }
+
+    // call phase
+    const Player& discarder = players[lastDiscardPlayer];
+    TileType discardType = *discarder.discards[discarder.discardCount - 1];
+    int8_t d = TYPE_INDEX_MAP[discardType];
+
+    // ron (needs a yaku, see scoreRonYaku)
+    if (player.canRon(d))
+        actions.push(Action(Action::Ron, playerIndex));
+
+    // calls (not allowed in riichi or on the last tile)
+    if (!player.riichiTurn && wallRemaining() > 0) {
+        // pon (with and without red tile)
+        if (counts[d] >= 2) {
+            if (counts[d] - (redIndex[d] != -1) >= 2) actions.push(Action(Action::Pon, playerIndex, -1, typeMask(d, 2, false)));
+            if (redIndex[d] != -1) actions.push(Action(Action::Pon, playerIndex, -1, typeMask(d, 2, true)));
+        }
+
+        // open kan
+        if (counts[d] == 3 && kanCount < MAX_KANS)
+            actions.push(Action(Action::Kan, playerIndex, -1, typeMask(d, 3, redIndex[d] != -1)));
+
+        // chi (only from player to the left)
+        if (Rules::CHI && playerIndex == (lastDiscardPlayer + 1) % Rules::PLAYER_COUNT) {
+            TileType prev = prevInRun(discardType);
+            TileType next = nextInRun(discardType);
+            TileType runs[3][2] = {{prevInRun(prev), prev}, {prev, next}, {next, nextInRun(next)}};
+            for (auto& run : runs) {
+                if (run[0] == NONE || run[1] == NONE) continue;
+                int8_t a = TYPE_INDEX_MAP[run[0]];
+                int8_t b = TYPE_INDEX_MAP[run[1]];
+                if (!counts[a] || !counts[b]) continue;
+                for (int redA = 0; redA < 2; ++redA) {
+                    if (redA ? redIndex[a] == -1 : counts[a] == (redIndex[a] != -1)) continue;
+                    for (int redB = 0; redB < 2; ++redB) {
+                        if (redB ? redIndex[b] == -1 : counts[b] == (redIndex[b] != -1)) continue;
+                        actions.push(Action(Action::Chi, playerIndex, -1, typeMask(a, 1, redA) | typeMask(b, 1, redB)));
+                    }
+                }
+            }
+        }
+    }
+
+    if (actions.size()) actions.push(Action(Action::Pass, playerIndex));
+}
+
+template <typename Rules>
+bool BasicBoard<Rules>::canReact(int8_t playerIndex) const {
+    if (playerIndex == lastDiscardPlayer) return false;
+    const Player& player = players[playerIndex];
+    const Hand& hand = player.hand;
+    const Player& discarder = players[lastDiscardPlayer];
+    uint64_t discardBit = 1ull << TYPE_INDEX_MAP[*discarder.discards[discarder.discardCount - 1]];
+    uint64_t reactMask = player.furiten() ? 0 : player.ronYakuMask;
+    if (!player.riichiTurn && wallRemaining() > 0)
+        reactMask |= hand.ponMask | (Rules::CHI && playerIndex == (lastDiscardPlayer + 1) % Rules::PLAYER_COUNT ? hand.chiMask : 0);
+    return reactMask & discardBit;
+}
+
+template <typename Rules>
+void BasicBoard<Rules>::passRon(int8_t caller) {
+    const Player& discarder = players[lastDiscardPlayer];
+    int8_t d = TYPE_INDEX_MAP[*discarder.discards[discarder.discardCount - 1]];
+    for (int i = 0; i < Rules::PLAYER_COUNT; ++i) {
+        Player& player = players[i];
+        // a winning tile is furiten to pass even when the hand has no yaku for it
+        if (i == lastDiscardPlayer || i == caller || !((player.hand.ronMask >> d) & 1) || player.furiten()) continue;
+        player.tempFuriten = true;
+        player.riichiFuriten |= player.riichiTurn != 0;
+    }
+}
+
+template <typename Rules>
+void BasicBoard<Rules>::scoreRonYaku(int8_t playerIndex) {
+    Player& player = players[playerIndex];
+    player.ronYakuScored = true;
+
+    // riichi is a yaku on every wait, other hands score all their waits at once (the yaku cannot change before the next discard)
+    player.ronYakuMask = player.riichiTurn ? player.hand.ronMask : 0;
+    if (player.riichiTurn) return;
+    WaitScores scores;
+    valueOfWaits(playerIndex, scores);
+    for (int i = 0; i < scores.size(); ++i)
+        if (scores[i].ron.han > 0) player.ronYakuMask |= 1ull << TYPE_INDEX_MAP[scores[i].tileType];
+}
+
+template <typename Rules>
+void BasicBoard<Rules>::nextTurn() {
+    if (wallRemaining() <= 0) {
+        phase = EndPhase;
+        settle();
+        return;
+    }
+    currentPlayer = (lastDiscardPlayer + 1) % Rules::PLAYER_COUNT;
+    ++turn;
+    Player& player = players[currentPlayer];
+    if (player.firstTurn == 0) player.firstTurn = turn;
+    drawTile(currentPlayer, natural);
+    phase = TurnPhase;
+}
+
+template <typename Rules>
+void BasicBoard<Rules>::declareKan(int8_t playerIndex) {
+    ++kanCount;
+    revealDora();
+    drawTile(playerIndex, kan);
+}
+
+template <typename Rules>
+bool BasicBoard<Rules>::tenpai(int8_t playerIndex) const {
+    const Hand& hand = players[playerIndex].hand;
+    uint64_t waits = hand.ronMask;
+    for (; waits; waits &= waits - 1) {
+        int t = std::countr_zero(waits);
+        if (hand.counts[t] + hand.callCounts[t] < 4) return true;
+    }
+    return false;
+}
+
+// payments are rounded up to 100, the dealer pays and receives double
+template <typename Rules>
+void BasicBoard<Rules>::settle() {
+    auto payment = [](int basicPoints, int multiplier) { return (basicPoints * multiplier + 99) / 100 * 100; };
+    if (winner == -1) {
+        // exhaustive draw, noten players pay tenpai players (riichi sticks stay on the table)
+        bool tenpaiPlayers[Rules::PLAYER_COUNT];
+        int tenpaiCount = 0;
+        for (int i = 0; i < Rules::PLAYER_COUNT; ++i)
+            tenpaiCount += tenpaiPlayers[i] = tenpai(i);
+        if (tenpaiCount == 0 || tenpaiCount == Rules::PLAYER_COUNT) return;
+        for (int i = 0; i < Rules::PLAYER_COUNT; ++i)
+            players[i].score += tenpaiPlayers[i] ? Rules::NOTEN_PAYMENT / tenpaiCount : -Rules::NOTEN_PAYMENT / (int)(Rules::PLAYER_COUNT - tenpaiCount);
+        return;
+    }
+
+    winScore = valueOfHand(winner);
+    int basicPoints = winScore.basicPoints();
+    Player& winning = players[winner];
+    if (loser != -1) {
+        int points = payment(basicPoints, winner == dealer ? 6 : 4);
+        players[loser].score -= points;
+        winning.score += points;
+    } else {
+        for (int i = 0; i < Rules::PLAYER_COUNT; ++i) {
+            if (i == winner) continue;
+            int points = payment(basicPoints, winner == dealer || i == dealer ? 2 : 1);
+            players[i].score -= points;
+            winning.score += points;
+        }
+    }
+    winning.score += riichiSticks * RIICHI_COST;
+    riichiSticks = 0;
+}
+
+template <typename Rules>
+void BasicBoard<Rules>::step(const Action& action) {
+    engineStats.countStep();
+    Player& player = players[action.player];
+    Hand& hand = player.hand;
+    switch (action.type) {
+    case Action::Discard:
+    case Action::Riichi: {
+        if (action.type == Action::Riichi) {
+            player.riichiTurn = turn;
+            player.score -= RIICHI_COST;
+            ++riichiSticks;
+        }
+        // skipping a tsumo in riichi is furiten
+        if (player.riichiTurn && action.type == Action::Discard && ((hand.ronMask >> TYPE_INDEX_MAP[hand[DRAWN_I]]) & 1))
+            player.riichiFuriten = true;
+        hand.swapDrawn(action.tileIndex);
+        Tile tile = hand.discardDrawn();
+        bool tsumogiri = tile.getLastAction() == Tile::Action::Drawn && tile.getLastActionTurn() == turn;
+        tile.setLastAction(tsumogiri ? Tile::Action::Tsumogiri : Tile::Action::Discard, turn);
+        player.discard(tile);
+        int8_t typeIndex = TYPE_INDEX_MAP[*tile];
+        if (action.type == Action::Riichi) player.riichiTile = typeIndex;
+        for (int i = 0; i < Rules::PLAYER_COUNT; ++i)
+            if (players[i].riichiTurn) players[i].safeMask |= 1ull << typeIndex; // discards since riichi are safe against it
+        reveal(typeIndex, action.player);
+        hand.updateWaits();
+        player.ronYakuMask = 0;
+        player.ronYakuScored = false;
+        player.lastTurn = turn;
+        lastDiscardPlayer = action.player;
+
+        // a ron needs a yaku, waits are scored the first time a discard hits them
+        for (int i = 0; i < Rules::PLAYER_COUNT; ++i) {
+            const Player& other = players[i];
+            if (i != action.player && !other.ronYakuScored && ((other.hand.ronMask >> typeIndex) & 1) && !other.furiten())
+                scoreRonYaku(i);
+        }
+
+        // wait for reactions only if some player can react
+        phase = CallPhase;
+        for (int i = 1; i < Rules::PLAYER_COUNT; ++i)
+            if (canReact((action.player + i) % Rules::PLAYER_COUNT)) return;
+        passRon(-1); // winning tiles a hand has no yaku for still make it furiten
+        nextTurn();
+        return;
+    }
+    case Action::Pass:
+        passRon(-1);
+        nextTurn();
+        return;
+    case Action::Tsumo:
+        winner = action.player;
+        loser = -1;
+        player.ronActive = false;
+        phase = EndPhase;
+        settle();
+        return;
+    case Action::Ron: {
+        const Player& discarder = players[lastDiscardPlayer];
+        hand.setTile(DRAWN_I, discarder.discards[discarder.discardCount - 1]);
+        winner = action.player;
+        loser = lastDiscardPlayer;
+        player.ronActive = true;
+        phase = EndPhase;
+        settle();
+        return;
+    }
+    case Action::Chi:
+    case Action::Pon:
+    case Action::Kan: {
+        passRon(action.player);
+        Player& discarder = players[lastDiscardPlayer];
+        Tile claimed = discarder.discards[discarder.discardCount - 1];
+        for (uint32_t mask = action.handMask; mask; mask &= mask - 1)
+            reveal(TYPE_INDEX_MAP[hand[std::countr_zero(mask)]], action.player); // claimed tile is already visible in the river
+        hand.call(action.handMask, claimed, true);
+        currentPlayer = action.player;
+        ++turn;
+        lastCallTurn = turn;
+        phase = TurnPhase;
+        if (action.type == Action::Kan) declareKan(action.player);
+        else lastDrawAction = action.type == Action::Pon ? pon : chi;
+        return;
+    }
+    case Action::ClosedKan:
+        for (uint32_t mask = action.handMask; mask; mask &= mask - 1)
+            reveal(TYPE_INDEX_MAP[hand[std::countr_zero(mask)]], action.player);
+        hand.call(action.handMask, Tile(), false);
+        lastCallTurn = turn;
+        declareKan(action.player);
+        return;
+    case Action::AddedKan:
+        reveal(TYPE_INDEX_MAP[hand[action.tileIndex]], action.player);
+        hand.extendCall(action.tileIndex);
+        lastCallTurn = turn;
+        declareKan(action.player);
+        return;
+    }
+}
+
 const Tile GAME_TILES[TILE_COUNT] = {
     Tile(DGNW), Tile(DGNW), Tile(DGNW), Tile(DGNW),
     Tile(DGNG), Tile(DGNG), Tile(DGNG), Tile(DGNG),
@@ -661,40 +1819,36 @@ const Tile GAME_TILES[TILE_COUNT] = {
 };
 
 void ScoreInfo::clear() {
-    yakuHan.clear();
-    doraCount = 0;
-    uradoraCount = 0;
-    redDoraCount = 0;
-    han = 0;
-    fu = 0;
+    *this = ScoreInfo();
 }
 
 inline void ScoreInfo::addYaku(Yaku yaku, int hanValue) {
-    yakuHan.emplace_back(yaku, hanValue);
+    yakuMask |= 1ULL << yaku;
+    yakuHan[yaku] += hanValue;
     han += hanValue;
 }
 
-inline void ScoreInfo::addDora() {
-    ++doraCount;
-    ++han;
+inline void ScoreInfo::addDora(int count) {
+    doraCount += count;
+    han += count;
 }
 
-inline void ScoreInfo::addUradora() {
-    ++uradoraCount;
-    ++han;
+inline void ScoreInfo::addUradora(int count) {
+    uradoraCount += count;
+    han += count;
 }
 
-inline void ScoreInfo::addRedDora() {
-    ++redDoraCount;
-    ++han;
+inline void ScoreInfo::addRedDora(int count) {
+    redDoraCount += count;
+    han += count;
 }
 
 inline int ScoreInfo::totalDora() {
     return doraCount + uradoraCount + redDoraCount;
 }
 
-const std::array<YakuInfo, 40> initYakuInfoMap() {
-    std::array<YakuInfo, 40> yakuInfoMap;
+const std::array<YakuInfo, YAKU_COUNT> initYakuInfoMap() {
+    std::array<YakuInfo, YAKU_COUNT> yakuInfoMap;
     yakuInfoMap[Riichi] = YakuInfo("Riichi");
     yakuInfoMap[DoubleRiichi] = YakuInfo("Double Riichi");
     yakuInfoMap[AllSimples] = YakuInfo("All Simples");
@@ -736,4 +1890,8 @@ const std::array<YakuInfo, 40> initYakuInfoMap() {
     yakuInfoMap[BlessingOfEarth] = YakuInfo("Blessing of Earth");
     yakuInfoMap[BlessingOfMan] = YakuInfo("Blessing of Man");
     return yakuInfoMap;
-}
\ No newline at end of file
+}
+
+template struct BasicBoard<StandardRules>;
+template struct BasicBoard<SanmaRules>;
+template struct BasicBoard<ClassicRules>;
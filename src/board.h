@@ -37,6 +37,10 @@ suited tiles
 #include <algorithm>
 #include <vector>
 #include <string>
+#include <bit>
+#include <cstring>
+#include <random>
+#include <type_traits>
 
 typedef int8_t TileType;
 
@@ -88,7 +92,12 @@ const size_t TILE_COUNT = 136; // number of tiles, also size of untouched wall
 const size_t PLAYER_COUNT = 4; // number of players
 const size_t DEAD_WALL_SIZE = 14; // size of dead wall
 const size_t DORA_OFFSET = 4; // index of first uradora
-const size_t MAX_DORA_INDICATORS = 4; // max number of top dora indicators
+const size_t MAX_DORA_INDICATORS = 5; // max number of top dora indicators (initial + one per kan)
+const size_t MAX_KANS = 4; // max number of kans per round (also number of rinshan tiles)
+const size_t TILE_TYPES = 34; // number of distinct tile types
+const size_t MAX_ACTIONS = 64; // max number of legal actions for a player at a single decision
+const int RIICHI_COST = 1000; // points deposited when declaring riichi
+const int EARLY_DISCARDS = 6; // first row of a river, read by the discard order danger heuristics
 const int MANGAN_HAN = 5; // number of han constituting a mangan
 const int YAKUMAN_HAN = 13; // number of han constituting a yakuman
 const int DOUBLE_YAKUMAN_HAN = 999; // identifier for double yakuman (must be large enough to never appear naturally)
@@ -98,15 +107,19 @@ const int DOUBLE_YAKUMAN_HAN = 999; // identifier for double yakuman (must be la
 
 const std::array<TileType, 1 << 7> initDoraMap(); // initializes doraMap
 const std::array<TileType, 1 << 7> DORA_MAP = initDoraMap(); // maps dora indicator to dora
+const std::array<int8_t, 1 << 6> initTypeIndexMap(); // initializes typeIndexMap
+const std::array<int8_t, 1 << 6> TYPE_INDEX_MAP = initTypeIndexMap(); // maps tile type to dense index in [0, TILE_TYPES) (same order as tile types)
+const std::array<TileType, TILE_TYPES> initIndexTypeMap(); // initializes indexTypeMap
+const std::array<TileType, TILE_TYPES> INDEX_TYPE_MAP = initIndexTypeMap(); // maps dense index back to tile type
 
-struct Tile; struct Group; struct Hand; struct Player; struct Board; struct ScoreInfo;
+struct Tile; struct Group; struct Hand; struct Player; template <typename Rules> struct BasicBoard; struct ScoreInfo; class WaitScores;
 
 extern const Tile GAME_TILES[TILE_COUNT]; // all game tiles (starting wall)
 
 // singular tile
 class Tile {
 public:
-    enum Action { Init, Drawn, Discard };
+    enum Action { Init, Drawn, Discard, Tsumogiri }; // tsumogiri is a discard of the tile drawn this turn
 private:
     TileType type; // is red | type (lower 6 bits)
     int lastActionTurn = 0;
@@ -119,6 +132,14 @@ public:
     Action getLastAction() const; // get last action
     int getLastActionTurn() const; // get last action turn
 };
+inline TileType Tile::operator*() const { return type & (TileType)0b0111111; }
+inline bool Tile::isRed() const { return (bool)(type & 0b1000000); }
+inline void Tile::setLastAction(Action action, int turn) {
+    lastAction = action;
+    lastActionTurn = turn;
+}
+inline Tile::Action Tile::getLastAction() const { return lastAction; }
+inline int Tile::getLastActionTurn() const { return lastActionTurn; }
 
 // groups of up to 4 tiles, essentially treated as an interval
 class Group {
@@ -131,15 +152,20 @@ public:
     bool valid(const Hand& hand) const; // determines if meld is valid
     uint32_t mask() const; // return a bitmask with tile indices marked
     int8_t& operator[](int8_t index); // returns tile index at specified index in tileIndices
+    int8_t operator[](int8_t index) const; // returns tile index at specified index in tileIndices
     int8_t size() const; // returns size of group
     bool open() const; // returns whether group is open
     bool locked() const; //returns whether group is locked
 };
+inline int8_t& Group::operator[](int8_t index) { return tileIndices[index]; }
+inline int8_t Group::operator[](int8_t index) const { return tileIndices[index]; }
+inline int8_t Group::size() const { return _size; }
+inline bool Group::open() const { return _open; }
+inline bool Group::locked() const { return _locked; }
 
 // wait
 struct Wait {
     TileType tileType = NONE;
-    uint8_t fu = 0;
 };
 
 // hand state
@@ -150,13 +176,49 @@ struct Hand {
     int8_t callTiles = 0; // number of tiles locked in calls, call tiles are at the start of the tiles array
     Wait waits[TILE_COUNT]; // waits in hand
     int waitCount = 0; // number of waits in hand
+    // closed tile counts and type index masks, kept up to date as tiles enter and leave the hand
+    uint8_t counts[TILE_TYPES] = {}; // closed (non-call) tiles by type index
+    uint8_t callCounts[TILE_TYPES] = {}; // call tiles by type index
+    uint64_t heldMask = 0; // types with 1+ closed tiles
+    uint64_t ponMask = 0; // types with 2+ closed tiles (can pon)
+    uint64_t kanMask = 0; // types with 3+ closed tiles (can open kan)
+    uint64_t chiMask = 0; // types completing a run with 2 closed tiles (can chi)
+    uint64_t ronMask = 0; // types completing the hand shape (updated by updateWaits)
     TileType operator[](size_t index) const; // get ith tile's type
     void swapDrawn(size_t index); // swap drawn tile with ith tile
     Tile discardDrawn(); // return drawn tile and discard it from hand
     bool operator==(const Hand& other) const; // check if hand equals another hand
     void clear(); // clears hand
-    void updateWaits(const Player& player); // update wait tiles
+    void updateWaits(); // update wait tiles
+    void call(uint32_t handMask, Tile claimed, bool open); // moves tiles in handMask (and claimed tile if any) into a new call meld
+    void extendCall(size_t index); // adds ith tile to the called triplet of the same type (added kan)
+    void setTile(size_t index, Tile tile); // places tile into empty closed slot
+    void recount(); // rebuilds counts and masks after tiles were written directly
+private:
+    void updateCount(TileType tileType, int delta); // adjusts closed count of a type and its masks
 };
+inline TileType Hand::operator[](size_t index) const { return *tiles[index]; }
+inline void Hand::swapDrawn(size_t index) { std::swap(tiles[index], tiles[DRAWN_I]); }
+inline Tile Hand::discardDrawn() {
+    Tile drawnTile;
+    std::swap(drawnTile, tiles[DRAWN_I]);
+    updateCount(*drawnTile, -1);
+    return drawnTile;
+}
+inline void Hand::clear() {
+    for (int i = 0; i < MAX_HAND_SIZE; ++i)
+        tiles[i] = NONE;
+    callMeldCount = 0;
+    callTiles = 0;
+    waitCount = 0;
+    std::memset(counts, 0, sizeof(counts));
+    std::memset(callCounts, 0, sizeof(callCounts));
+    heldMask = 0;
+    ponMask = 0;
+    kanMask = 0;
+    chiMask = 0;
+    ronMask = 0;
+}
 
 // player state
 struct Player {
@@ -168,75 +230,75 @@ struct Player {
     int lastTurn = 0;
     int firstTurn = 0;
     bool ronActive = false;
+    uint64_t discardMask = 0; // types discarded this round (by type index), grows with discards
+    uint64_t safeMask = 0; // types that cannot deal in to this player (own discards, and every discard since its riichi)
+    uint64_t earlyMask = 0; // types among the first EARLY_DISCARDS discards
+    int8_t riichiTile = -1; // type index of the riichi declaration discard, -1 if not in riichi
+    uint8_t danger[TILE_TYPES] = {}; // chance in tenths of a percent that a tile type deals in to this player if it is tenpai (kept up to date by the board)
+    bool tempFuriten = false; // passed a ron since own last discard
+    bool riichiFuriten = false; // passed a winning tile after declaring riichi
+    int8_t seatWind = 0; // seat wind this round (east deals), set by the board as the deal moves
+    uint64_t ronYakuMask = 0; // winning types whose ron scores a yaku (valid once ronYakuScored)
+    bool ronYakuScored = false; // whether the board scored the current waits (lazily, on the first discard that hits them)
     void initRound();
+    void discard(Tile tile); // appends tile to discards (ends temporary furiten)
+    bool furiten() const; // whether player may not win by ron
+    bool canRon(int8_t typeIndex) const; // whether tile type completes hand with a yaku and player is not furiten
 };
+inline bool Player::furiten() const {
+    return (hand.ronMask & discardMask) || tempFuriten || riichiFuriten;
+}
 
-// board state
-// wind values: 00 = east, 01 = south, 10 = west, 11 = north, matches last 2 bits on wind tile types
-struct Board {
-    enum DrawAction { natural, pon, chi, kan };
-    Player players[PLAYER_COUNT]; // array of players (indexed by wind)
-    Tile wall[TILE_COUNT]; // wall
-    int drawIndex; // next tile in wall to draw from
-    int revealedDora; // number of revealed dora
-    int turn; // current turn starting at 1
-    int lastCallTurn; // turn of last call 0 if none
-    int8_t lastDiscardPlayer; // player who discarded last
-    DrawAction lastDrawAction; // last draw action
-    int8_t roundWind; // round/prevalent wind
-    int8_t seatWind; // seat wind
-    Board() { initGame(); }
-    ScoreInfo valueOfHand(int8_t playerIndex) const; // gets basic point value of a player's hand
-    void initGame(); // reset to start of game
-    void nextRound(); // sets up game to start of next round
-    TileType getDora(int index, bool ura) const; // get dora/uradora at specified index
-    void drawTile(int8_t playerIndex, DrawAction drawActionType); // draw tile from wall
-};
+inline bool Player::canRon(int8_t typeIndex) const {
+    return ((ronYakuMask >> typeIndex) & 1) && !furiten();
+}
 
-// sorted permutation of hand (empty tiles at the end)
-// used for translation between sorted hand and original hand (similar to virtual addressing)
-class SortedHand {
-public:
-    // element of sorted hand
-    struct SortedTile {
-        TileType type; // tile type
-        int originalIndex; // original unsorted index
-        int nextTypeIndice; // index of next element in sortedHand with different type (used for finding runs)
-        SortedTile() {}
-        SortedTile(TileType type, int originalIndex) : type(type), originalIndex(originalIndex) {}
-        inline int operator*() const { return originalIndex; }
-    };
-private:
-    int8_t _size;
-    SortedTile tiles[MAX_HAND_SIZE];
-public:
-    SortedHand(const Hand& hand) {
-        // copy non-call and non-empty tiles into hand
-        _size = MAX_HAND_SIZE - hand.callTiles;
-        int j = 0;
-        for (int i = hand.callTiles; i < MAX_HAND_SIZE; ++i) {
-            TileType type = *hand.tiles[i];
-            tiles[type == NONE ? --_size : j++] = SortedTile(type, i);
-        }
+// player decision, applied with Board::step
+struct Action {
+    enum Type : int8_t { Pass, Discard, Riichi, Tsumo, Ron, Chi, Pon, Kan, ClosedKan, AddedKan };
+    Type type = Pass;
+    int8_t player = -1; // acting player
+    int8_t tileIndex = -1; // hand index of discarded tile (discard, riichi) or added tile (added kan)
+    uint32_t handMask = 0; // hand indices of tiles used in a call (same layout as Group::mask)
+    Action() {}
+    Action(Type type, int8_t player, int8_t tileIndex = -1, uint32_t handMask = 0) : type(type), player(player), tileIndex(tileIndex), handMask(handMask) {}
+};
 
-        // sort tiles
-        std::sort(tiles, tiles + _size, [](SortedTile& a, SortedTile& b) {
-            return a.type < b.type;
-        });
+// call phase priority of an action (ron, then pon and kans, then chi), used to resolve simultaneous calls
+inline int callPriority(Action::Type type) {
+    switch (type) {
+    case Action::Ron: return 3;
+    case Action::Pon:
+    case Action::Kan: return 2;
+    case Action::Chi: return 1;
+    default: return 0;
+    }
+}
 
-        // for non-call tiles define nextTypeIndice
-        tiles[_size-1].nextTypeIndice = _size;
-        for (int i = _size-2; i >= 0; --i)
-            tiles[i].nextTypeIndice = tiles[i].type == tiles[i+1].type ? tiles[i+1].nextTypeIndice : i+1;
+// fixed capacity list of actions (never allocates)
+class ActionList {
+    Action actions[MAX_ACTIONS];
+    int8_t _size = 0;
+public:
+    inline Action& operator[](int8_t index) {
+        return actions[index];
     }
 
-    inline SortedTile& operator[](int8_t index) {
-        return tiles[index];
+    inline const Action& operator[](int8_t index) const {
+        return actions[index];
     }
 
     inline int8_t size() const {
         return _size;
     }
+
+    inline void push(Action action) {
+        actions[_size++] = action;
+    }
+
+    inline void clear() {
+        _size = 0;
+    }
 };
 
 enum Yaku {
@@ -281,6 +343,7 @@ enum Yaku {
     BlessingOfEarth,
     BlessingOfMan,
 };
+const int YAKU_COUNT = BlessingOfMan + 1; // number of yaku (must fit in yaku mask)
 
 struct YakuInfo {
     std::string name;
@@ -289,21 +352,254 @@ struct YakuInfo {
     YakuInfo(std::string name) : name(name) {}
 };
 
-const std::array<YakuInfo, 40> initYakuInfoMap(); // initializes yakuInfoMap
-const std::array<YakuInfo, 40> YAKU_INFO_MAP = initYakuInfoMap(); // maps yaku to its info
+const std::array<YakuInfo, YAKU_COUNT> initYakuInfoMap(); // initializes yakuInfoMap
+const std::array<YakuInfo, YAKU_COUNT> YAKU_INFO_MAP = initYakuInfoMap(); // maps yaku to its info
 
+// plain old data so results can be copied, compared (memcmp) and written out in bulk, keep free of implicit padding
 struct ScoreInfo {
-    std::vector<std::pair<Yaku, int>> yakuHan; // pair of yaku and its han value (closed variants may have different han)
-    int doraCount = 0;
-    int uradoraCount = 0;
-    int redDoraCount = 0;
-    int han = 0;
-    int fu = 0;
-    int basicPoints(); // caculates basic points based on han and fu
+    uint64_t yakuMask = 0; // bit per yaku present
+    int16_t yakuHan[YAKU_COUNT] = {}; // han value per yaku (closed variants may have different han), 0 if absent
+    int16_t han = 0;
+    int16_t fu = 0;
+    int8_t doraCount = 0;
+    int8_t uradoraCount = 0;
+    int8_t redDoraCount = 0;
+    int8_t reserved = 0; // explicit padding
+    int basicPoints() const; // caculates basic points based on han and fu
     inline void clear(); // clears score
     inline void addYaku(Yaku yaku, int han); // adds yaku
-    inline void addDora(); // adds 1 dora
-    inline void addUradora(); // adds 1 uradora
-    inline void addRedDora(); // adds 1 red dora
+    inline void addDora(int count = 1); // adds dora
+    inline void addUradora(int count = 1); // adds uradora
+    inline void addRedDora(int count = 1); // adds red dora
     inline int totalDora(); // gets total dora
-};
\ No newline at end of file
+    inline bool hasYaku(Yaku yaku) const {
+        return (yakuMask >> yaku) & 1;
+    }
+    inline int yakuCount() const {
+        return std::popcount(yakuMask);
+    }
+    inline bool operator==(const ScoreInfo& other) const {
+        return memcmp(this, &other, sizeof(ScoreInfo)) == 0;
+    }
+};
+static_assert(YAKU_COUNT <= 64);
+static_assert(std::is_trivially_copyable_v<ScoreInfo>);
+static_assert(std::has_unique_object_representations_v<ScoreInfo>); // no padding, so memcmp is equality
+
+// rule sets, the board and scorer are compiled once per rule set so a variant never checks another's rules
+// 4 player rules (also the defaults used by PLAYER_COUNT and TILE_COUNT)
+struct StandardRules {
+    static constexpr size_t PLAYER_COUNT = ::PLAYER_COUNT; // number of players
+    static constexpr size_t TILE_COUNT = ::TILE_COUNT; // size of untouched wall
+    static constexpr int RED_FIVES = 3; // red fives in the wall, one per suit (extras go to pin)
+    static constexpr bool MAN_TERMINALS_ONLY = false; // man 2-8 removed from the wall
+    static constexpr bool CHI = true; // runs can be called
+    static constexpr bool OPEN_TANYAO = true; // all simples counts with open melds (kuitan)
+    static constexpr bool DOUBLE_YAKUMAN = true; // double yakuman hands score two yakuman (otherwise one)
+    static constexpr int NOTEN_PAYMENT = 3000; // split between tenpai players on an exhaustive draw
+};
+
+// 3 player rules / sanma (no man 2-8 and no chi, north is played as a plain wind since nukidora is not handled)
+struct SanmaRules {
+    static constexpr size_t PLAYER_COUNT = 3;
+    static constexpr size_t TILE_COUNT = 108;
+    static constexpr int RED_FIVES = 2;
+    static constexpr bool MAN_TERMINALS_ONLY = true;
+    static constexpr bool CHI = false;
+    static constexpr bool OPEN_TANYAO = true;
+    static constexpr bool DOUBLE_YAKUMAN = true;
+    static constexpr int NOTEN_PAYMENT = 2000;
+};
+
+// 4 player rules without kuitan or double yakuman (all simples needs a closed hand, yakuman hands score one yakuman)
+struct ClassicRules : StandardRules {
+    static constexpr bool OPEN_TANYAO = false;
+    static constexpr bool DOUBLE_YAKUMAN = false;
+};
+
+// board state
+// wind values: 00 = east, 01 = south, 10 = west, 11 = north, matches last 2 bits on wind tile types
+// players sit in turn order, the dealer sits east and the deal passes to the next player every round
+// wall layout: indices [0, MAX_KANS) are rinshan tiles, dora indicators follow at DORA_OFFSET, live wall is drawn from the top down
+template <typename Rules>
+struct BasicBoard {
+    enum DrawAction { natural, pon, chi, kan };
+    enum Phase { TurnPhase, CallPhase, EndPhase }; // current player to discard / others to react to discard / round over
+    Player players[Rules::PLAYER_COUNT]; // array of players (in turn order, Player::seatWind is relative to the dealer)
+    Tile wall[Rules::TILE_COUNT]; // wall
+    int drawIndex; // next tile in wall to draw from
+    int revealedDora; // number of revealed dora
+    uint8_t doraCounts[TILE_TYPES]; // dora multiplicity by type index (from revealed indicators)
+    uint8_t uradoraCounts[TILE_TYPES]; // uradora multiplicity by type index (only counted for riichi hands)
+    uint8_t visibleCounts[TILE_TYPES]; // tiles every player can see by type index (rivers, revealed call tiles and dora indicators)
+    uint8_t unseenCounts[Rules::PLAYER_COUNT][TILE_TYPES]; // tiles each player cannot see by type index (walls and other closed hands)
+    int kanCount; // number of kans declared this round (rinshan tiles drawn)
+    int turn; // current turn starting at 1
+    int lastCallTurn; // turn of last call 0 if none
+    int8_t lastDiscardPlayer; // player who discarded last
+    DrawAction lastDrawAction; // last draw action
+    Phase phase; // current phase of play
+    int8_t currentPlayer; // player whose turn it is (discarding player during call phase)
+    int8_t winner; // winning player, -1 if none (exhaustive draw or round in progress)
+    int8_t loser; // player who dealt into ron, -1 if none
+    int riichiSticks; // riichi deposits on the table
+    int8_t roundWind; // round/prevalent wind
+    int8_t dealer; // player in the east seat
+    ScoreInfo winScore; // value of the winning hand once the round is won (empty otherwise)
+    std::mt19937_64 random; // wall shuffle, seed before initGame / nextRound to replay rounds
+    BasicBoard() { initGame(); }
+    ScoreInfo valueOfHand(int8_t playerIndex) const; // gets basic point value of a player's hand
+    void valueOfWaits(int8_t playerIndex, WaitScores& scores) const; // scores every winning tile of a player's 13 tile hand (ron and tsumo)
+    void initGame(); // reset to start of game
+    void nextRound(); // passes the deal to the next player and sets up the round (shuffles, deals and draws for dealer)
+    TileType getDora(int index, bool ura) const; // get dora/uradora at specified index
+    void revealDora(); // reveals next dora indicator and updates dora tables
+    void drawTile(int8_t playerIndex, DrawAction drawActionType); // draw tile from wall (rinshan tile for kan)
+    int wallRemaining() const; // number of tiles left in live wall
+    uint8_t tileDanger(int8_t playerIndex, int8_t typeIndex) const; // danger of discarding a type against a player, from the current rivers (Player::danger keeps it)
+    bool tenpai(int8_t playerIndex) const; // whether a player waits on a tile it does not hold every copy of itself (karaten is noten)
+    void legalActions(int8_t playerIndex, ActionList& actions) const; // fills actions with player's legal actions (empty if player has no decision)
+    void step(const Action& action); // applies action and advances play to the next decision
+private:
+    void dealRound(); // shuffles the wall, deals and draws for the dealer
+    bool canReact(int8_t playerIndex) const; // whether player has any legal reaction to the last discard (a few mask tests)
+    void passRon(int8_t caller); // marks players who declined a ron on the last discard as furiten
+    void scoreRonYaku(int8_t playerIndex); // fills the player's ronYakuMask from the scores of its waits (13 tile hand)
+    void nextTurn(); // advances to next player's draw after a discard (or ends round on exhausted wall)
+    void declareKan(int8_t playerIndex); // draws rinshan tile and reveals dora after a kan
+    void settle(); // pays out the finished round (win and riichi sticks, or noten payments on exhaustive draw)
+    void reveal(int8_t typeIndex, int8_t owner = -1); // counts a tile every player can see (owner already held it) and updates danger around it
+    void updateDanger(int8_t typeIndex); // recomputes every player's danger over the suit of a type index (or the single honor)
+};
+
+typedef BasicBoard<StandardRules> Board; // 4 player board
+typedef BasicBoard<SanmaRules> SanmaBoard; // 3 player board
+typedef BasicBoard<ClassicRules> ClassicBoard; // 4 player board without kuitan or double yakuman
+
+// shape checks over closed tile counts (indexed by type index)
+bool isComplete(const uint8_t counts[TILE_TYPES]); // whether counts form a complete hand (groups + pair, 7 pairs or 13 orphans)
+uint64_t waitMask(uint8_t counts[TILE_TYPES]); // bitmask of type indices that complete counts (counts restored before return)
+
+// sorted permutation of hand (empty tiles at the end)
+// used for translation between sorted hand and original hand (similar to virtual addressing)
+class SortedHand {
+public:
+    // element of sorted hand
+    struct SortedTile {
+        TileType type; // tile type
+        int originalIndex; // original unsorted index
+        int nextTypeIndice; // index of next element in sortedHand with different type (used for finding runs)
+        SortedTile() {}
+        SortedTile(TileType type, int originalIndex) : type(type), originalIndex(originalIndex) {}
+        inline int operator*() const { return originalIndex; }
+    };
+private:
+    int8_t _size;
+    SortedTile tiles[MAX_HAND_SIZE];
+public:
+    SortedHand() : _size(0) {}
+    SortedHand(const Hand& hand) {
+        assign(hand);
+    }
+
+    // sorts non-call and non-empty tiles of hand by type (counting sort, nextTypeIndice filled on placement)
+    inline void assign(const Hand& hand) {
+        // count tiles per type (types fit in 6 bits so a 64 bit mask tracks which are present)
+        int8_t typeStarts[1 << 6];
+        int8_t typeEnds[1 << 6];
+        TileType types[MAX_HAND_SIZE];
+        uint64_t typeMask = 0;
+        for (int i = hand.callTiles; i < MAX_HAND_SIZE; ++i) {
+            types[i] = *hand.tiles[i];
+            typeMask |= 1ull << types[i];
+            typeEnds[types[i]] = 0;
+        }
+        for (int i = hand.callTiles; i < MAX_HAND_SIZE; ++i)
+            ++typeEnds[types[i]];
+        typeMask &= ~(1ull << NONE);
+
+        // bucket ranges in type order
+        int8_t offset = 0;
+        for (uint64_t mask = typeMask; mask; mask &= mask - 1) {
+            int type = std::countr_zero(mask);
+            typeStarts[type] = offset;
+            offset += typeEnds[type];
+            typeEnds[type] = offset;
+        }
+        _size = offset;
+
+        // place tiles (stable, so copies keep their hand order)
+        for (int i = hand.callTiles; i < MAX_HAND_SIZE; ++i) {
+            TileType type = types[i];
+            if (type == NONE) continue;
+            SortedTile& tile = tiles[typeStarts[type]++];
+            tile = SortedTile(type, i);
+            tile.nextTypeIndice = typeEnds[type];
+        }
+    }
+
+    // inserts a tile in order (adds a winning tile to an already sorted hand)
+    void insert(TileType type, int originalIndex) {
+        int i = _size++;
+        for (; i > 0 && tiles[i-1].type > type; --i)
+            tiles[i] = tiles[i-1];
+        tiles[i] = SortedTile(type, originalIndex);
+        linkTypes();
+    }
+
+    inline SortedTile& operator[](int8_t index) {
+        return tiles[index];
+    }
+
+    inline int8_t size() const {
+        return _size;
+    }
+private:
+    // for non-call tiles define nextTypeIndice
+    void linkTypes() {
+        tiles[_size-1].nextTypeIndice = _size;
+        for (int i = _size-2; i >= 0; --i)
+            tiles[i].nextTypeIndice = tiles[i].type == tiles[i+1].type ? tiles[i+1].nextTypeIndice : i+1;
+    }
+};
+
+void sortHands(const Hand* hands, SortedHand* sortedHands, size_t count); // sorts a batch of hands (sortedHands must hold count elements)
+
+// value of winning on a tile
+struct WaitScore {
+    TileType tileType = NONE; // winning tile type
+    ScoreInfo ron; // value when winning by ron (empty if furiten)
+    ScoreInfo tsumo; // value when winning by tsumo
+};
+
+// scores of every winning tile of a hand (never allocates)
+class WaitScores {
+    WaitScore scores[TILE_TYPES];
+    int8_t _size = 0;
+public:
+    inline WaitScore& operator[](int8_t index) {
+        return scores[index];
+    }
+
+    inline const WaitScore& operator[](int8_t index) const {
+        return scores[index];
+    }
+
+    inline int8_t size() const {
+        return _size;
+    }
+
+    inline WaitScore& push(TileType tileType) {
+        scores[_size].tileType = tileType;
+        return scores[_size++];
+    }
+
+    inline void clear() {
+        _size = 0;
+    }
+};
+
+// board members are defined in board.cpp for these rule sets only
+extern template struct BasicBoard<StandardRules>;
+extern template struct BasicBoard<SanmaRules>;
+extern template struct BasicBoard<ClassicRules>;
@@ -0,0 +1,30 @@
+#include "corpus.h"
+
+void loadHand(const CorpusRecord& record, Hand& hand) {
+    hand.clear();
+    for (int i = 0; i < MAX_HAND_SIZE; ++i)
+        hand.tiles[i] = Tile(record.tiles[i] & 0b111111, record.tiles[i] >> 6);
+    hand.callTiles = record.callTiles;
+    hand.callMeldCount = record.callMeldCount;
+    int8_t index = 0;
+    for (int m = 0; m < record.callMeldCount; ++m) {
+        Group& group = hand.callMelds[m] = Group(record.melds[m] & 0b111, record.melds[m] & CORPUS_MELD_OPEN, true);
+        for (int k = 0; k < group.size(); ++k)
+            group[k] = index++;
+    }
+    hand.recount();
+}
+
+bool HandCorpus::open(const std::string& path) {
+    header = nullptr;
+    if (!file.open(path) || file.size() < sizeof(CorpusHeader)) return false;
+    const CorpusHeader* fileHeader = (const CorpusHeader*)file.data();
+    if (fileHeader->magic != CORPUS_MAGIC || fileHeader->version != CORPUS_VERSION || fileHeader->recordSize != sizeof(CorpusRecord)
+        || file.size() != sizeof(CorpusHeader) + fileHeader->recordCount * sizeof(CorpusRecord)) {
+        file.close();
+        return false;
+    }
+    header = fileHeader;
+    records = (const CorpusRecord*)(file.data() + sizeof(CorpusHeader));
+    return true;
+}
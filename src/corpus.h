@@ -0,0 +1,63 @@
+#pragma once
+
+#include "board.h"
+#include "mapped_file.h"
+#include <string>
+
+/* hand corpus file layout (native endianness)
+    CorpusHeader
+    CorpusRecord records[recordCount] - fixed size records, so record i is read straight from the mapping
+records
+    tiles hold the tile type with the red flag in bit 6 (0 for empty slots), call tiles first and drawn tile last
+    call melds are consecutive runs of call tiles in meld order, melds[m] holds the meld size and open flag
+*/
+
+const uint32_t CORPUS_MAGIC = 0x50524348; // "HCRP"
+const uint32_t CORPUS_VERSION = 1; // bump when record layout changes
+
+// kind of hand stored in a record
+enum CorpusKind : uint8_t {
+    CorpusComplete, // closed winning hand (14 tiles, winning tile in the drawn slot)
+    CorpusTenpai, // closed hand one tile from winning (13 tiles, drawn slot empty)
+    CorpusOpen, // winning hand with 1-4 call melds
+    CorpusMultiDecomposition, // closed winning hand of one suit with several group decompositions
+    CORPUS_KINDS
+};
+
+const uint8_t CORPUS_RON = 1 << 0; // record flag, hand wins on a discard instead of a self draw
+const uint8_t CORPUS_MELD_OPEN = 1 << 3; // meld flag, meld was called from a discard (size in the low 3 bits)
+
+struct CorpusHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordSize; // sizeof(CorpusRecord) when written
+    uint32_t reserved;
+    uint64_t recordCount;
+    uint64_t seed; // generator seed (same seed and counts give the same file)
+    uint64_t kindCounts[CORPUS_KINDS]; // records per kind (records are grouped by kind in this order)
+};
+
+struct CorpusRecord {
+    uint8_t tiles[MAX_HAND_SIZE];
+    uint8_t kind; // CorpusKind
+    uint8_t flags; // record flags
+    int8_t callTiles;
+    int8_t callMeldCount;
+    uint8_t melds[MAX_GROUPS]; // meld flags
+    uint8_t reserved[4];
+};
+static_assert(sizeof(CorpusRecord) == 32, "corpus records are written as raw bytes");
+
+void loadHand(const CorpusRecord& record, Hand& hand); // rebuilds hand (counts and masks included) from a record
+
+// memory mapped corpus written by tools/corpus_gen, so repeated benchmark runs read the same hands without regenerating them
+class HandCorpus {
+    MappedFile file;
+    const CorpusHeader* header = nullptr;
+    const CorpusRecord* records = nullptr;
+public:
+    bool open(const std::string& path); // maps corpus, false if missing, truncated or another version
+    inline const CorpusHeader& info() const { return *header; }
+    inline size_t size() const { return header ? header->recordCount : 0; }
+    inline const CorpusRecord& operator[](size_t index) const { return records[index]; }
+};
@@ -0,0 +1,153 @@
+#include "efficiency_bot.h"
+#include "hand_odds.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <tuple>
+
+const int FOLD_SHANTEN = 2; // shanten from which the bot folds against another player's riichi
+const int UKEIRE_SHANTEN = 0; // shanten up to which discard ties go to the most effective tiles (ukeire costs about two discardShanten calls)
+const int8_t CENTRALITY[9] = {0, 1, 2, 3, 3, 3, 2, 1, 0}; // by position in suit, middle tiles join more runs
+
+// honor types that are a yaku as a triplet for a player, the winds groupSetPoints credits: dragons, the round wind and its seat wind
+template <typename Rules>
+uint64_t valueHonors(const BasicBoard<Rules>& board, int8_t playerIndex) {
+    uint64_t mask = 0b111ull | 1ull << (3 + board.players[playerIndex].seatWind);
+    if (board.roundWind >= 0 && board.roundWind < 4) mask |= 1ull << (3 + board.roundWind); // past the north round no wind is the round wind
+    return mask;
+}
+
+// how much a held type is worth keeping next to the rest of the hand, discards with equal shanten drop the lowest first
+// dora, then neighbours and copies (shapes that may still turn into groups), then unseen copies left to complete them
+int tileValue(int t, const uint8_t counts[TILE_TYPES], const uint8_t unseen[TILE_TYPES], const uint8_t doraCounts[TILE_TYPES], uint64_t valueMask) {
+    int value = 8 * doraCounts[t] + unseen[t] + 4 * (counts[t] - 1);
+    if (t < 7) return value + 2 * ((valueMask >> t) & 1);
+    int position = (t - 7) % 9;
+    value += CENTRALITY[position];
+    for (int gap = 1; gap <= 2; ++gap) {
+        if (position >= gap) value += (3 - gap) * 2 * counts[t - gap];
+        if (position + gap < 9) value += (3 - gap) * 2 * counts[t + gap];
+    }
+    return value;
+}
+
+template <typename Rules>
+int efficiencyPolicy(const BasicBoard<Rules>& board, int8_t playerIndex, const ActionList& actions) {
+    if (actions.size() == 1) return 0; // riichi discards
+    for (int i = 0; i < actions.size(); ++i)
+        if (actions[i].type == Action::Tsumo || actions[i].type == Action::Ron) return i; // wins are only offered with a yaku
+
+    const Player& player = board.players[playerIndex];
+    const Hand& hand = player.hand;
+    int melds = hand.callMeldCount;
+    const uint8_t* unseen = board.unseenCounts[playerIndex];
+    uint64_t valueMask = valueHonors(board, playerIndex);
+    bool threatened = false; // another player is in riichi
+    for (int p = 0; p < Rules::PLAYER_COUNT; ++p)
+        threatened |= p != playerIndex && board.players[p].riichiTurn;
+
+    // closed counts without the tiles of a call or kan (hand indices in handMask)
+    uint8_t counts[TILE_TYPES];
+    auto without = [&](uint32_t handMask) {
+        std::memcpy(counts, hand.counts, sizeof(counts));
+        for (uint32_t mask = handMask; mask; mask &= mask - 1)
+            --counts[TYPE_INDEX_MAP[hand[std::countr_zero(mask)]]];
+        return counts;
+    };
+
+    if (board.phase == BasicBoard<Rules>::CallPhase) {
+        int pass = actions.size() - 1; // pass is last
+        if (player.riichiTurn) return pass;
+        const Player& discarder = board.players[board.lastDiscardPlayer];
+        int8_t d = TYPE_INDEX_MAP[*discarder.discards[discarder.discardCount - 1]];
+        bool open = false;
+        for (int m = 0; m < melds; ++m)
+            open |= hand.callMelds[m].open();
+        bool valuePon = (valueMask >> d) & 1;
+        if (!open && !valuePon) return pass; // a closed hand only opens for a pon the scorer credits as yakuhai
+        int current = shanten(hand.counts, melds);
+        if (threatened && current >= FOLD_SHANTEN) return pass;
+
+        // call lowering shanten the most (a value pon may keep it, it brings the yaku)
+        int choice = pass, best = current + 1;
+        for (int i = 0; i < pass; ++i) {
+            const Action& action = actions[i];
+            if (action.type != Action::Pon && (!open || (action.type != Action::Chi && action.type != Action::Kan))) continue;
+            without(action.handMask);
+            int called;
+            if (action.type == Action::Kan) {
+                called = shanten(counts, melds + 1); // a rinshan tile is drawn before the discard
+            } else {
+                int8_t shantens[TILE_TYPES];
+                discardShanten(counts, melds + 1, shantens);
+                called = *std::min_element(shantens, shantens + TILE_TYPES);
+            }
+            bool keep = action.type == Action::Pon && valuePon ? called <= current : called < current;
+            if (keep && called < best) {
+                best = called;
+                choice = i;
+            }
+        }
+        return choice;
+    }
+
+    // turn phase (riichi players may only discard the drawn tile or make a kan keeping their waits)
+    int8_t shantens[TILE_TYPES];
+    discardShanten(hand.counts, melds, shantens);
+    int best = *std::min_element(shantens, shantens + TILE_TYPES);
+    for (int i = 0; i < actions.size(); ++i) {
+        const Action& action = actions[i];
+        if (action.type == Action::ClosedKan && (player.riichiTurn || shanten(without(action.handMask), melds + 1) <= best)) return i;
+        if (action.type == Action::AddedKan && shantens[TYPE_INDEX_MAP[hand[action.tileIndex]]] == best) return i;
+    }
+
+    // effective tiles after discarding a type, computed once per type
+    int16_t effective[TILE_TYPES];
+    std::memset(effective, -1, sizeof(effective));
+    std::memcpy(counts, hand.counts, sizeof(counts));
+    auto ukeireAfter = [&](int8_t t) {
+        if (effective[t] < 0) {
+            --counts[t];
+            effective[t] = ukeire(counts, melds, unseen, shantens[t]);
+            ++counts[t];
+        }
+        return effective[t];
+    };
+
+    // riichi at once on the wait with the most unseen winning tiles
+    int choice = -1;
+    std::tuple<int, int> bestRiichi;
+    for (int i = 0; i < actions.size(); ++i) {
+        if (actions[i].type != Action::Riichi) continue;
+        int8_t t = TYPE_INDEX_MAP[hand[actions[i].tileIndex]];
+        std::tuple<int, int> key(-ukeireAfter(t), tileValue(t, counts, unseen, board.doraCounts, valueMask));
+        if (choice < 0 || key < bestRiichi) {
+            bestRiichi = key;
+            choice = i;
+        }
+    }
+    if (choice >= 0) return choice;
+
+    // discard by (danger when folding, shanten, effective tiles near tenpai, tile value, red five kept)
+    bool fold = threatened && best >= FOLD_SHANTEN;
+    std::tuple<int, int, int, int, bool> bestDiscard;
+    for (int i = 0; i < actions.size(); ++i) {
+        if (actions[i].type != Action::Discard) continue;
+        int8_t t = TYPE_INDEX_MAP[hand[actions[i].tileIndex]];
+        if (!fold && shantens[t] != best) continue;
+        int danger = 0;
+        for (int p = 0; fold && p < Rules::PLAYER_COUNT; ++p)
+            danger += p != playerIndex && board.players[p].riichiTurn ? board.players[p].danger[t] : 0;
+        int tiles = !fold && best <= UKEIRE_SHANTEN ? ukeireAfter(t) : 0;
+        std::tuple<int, int, int, int, bool> key(danger, shantens[t], -tiles, tileValue(t, counts, unseen, board.doraCounts, valueMask),
+                                                 hand.tiles[actions[i].tileIndex].isRed());
+        if (choice < 0 || key < bestDiscard) {
+            bestDiscard = key;
+            choice = i;
+        }
+    }
+    return std::max(choice, 0);
+}
+
+template int efficiencyPolicy<StandardRules>(const Board&, int8_t, const ActionList&);
+template int efficiencyPolicy<SanmaRules>(const SanmaBoard&, int8_t, const ActionList&);
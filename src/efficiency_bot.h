@@ -0,0 +1,15 @@
+#pragma once
+
+#include "board.h"
+
+// efficiency bot, a cheap reference opponent without search (default tournament policy and benchmark fill-in)
+// wins whenever it can and keeps the lowest shanten: tenpai discards go to the wait on the most unseen tiles,
+// other ties to the least connected tile, and riichi is declared as soon as it is offered on the widest wait
+// calls are pons of value honors, and pons and chis lowering shanten once the hand is open
+// from 2 shanten it folds against a riichi, discarding the tile least likely to deal in (Player::danger)
+// returns an index into actions (stateless, safe to call from any thread)
+template <typename Rules>
+int efficiencyPolicy(const BasicBoard<Rules>& board, int8_t playerIndex, const ActionList& actions);
+
+extern template int efficiencyPolicy<StandardRules>(const Board&, int8_t, const ActionList&);
+extern template int efficiencyPolicy<SanmaRules>(const SanmaBoard&, int8_t, const ActionList&);
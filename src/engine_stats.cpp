@@ -0,0 +1,3 @@
+#include "engine_stats.h"
+
+EngineStats engineStats;
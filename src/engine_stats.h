@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+
+// stages of BasicBoard::valueOfHand timed by the engine stats
+enum ScoringStage { SortStage, GroupSetStage, SpecialStage };
+const int SCORING_STAGES = SpecialStage + 1;
+const uint64_t STAGE_SAMPLE_INTERVAL = 64; // scoring calls per timed call
+
+// live engine counters for the performance overlay, lock-free (relaxed atomics) so any thread may update or read them
+// only collected while enabled, otherwise the engine pays one relaxed load per step or scoring call
+struct EngineStats {
+    std::atomic<bool> enabled = false;
+    std::atomic<uint64_t> steps = 0; // BasicBoard::step calls
+    std::atomic<uint64_t> scoringCalls = 0; // BasicBoard::valueOfHand calls
+    std::atomic<uint32_t> stageNanos[SCORING_STAGES] = {}; // latest sampled time of each scoring stage
+
+    inline void countStep() {
+        if (enabled.load(std::memory_order_relaxed)) steps.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // counts a scoring call, returns whether its stages should be timed
+    inline bool countScoring() {
+        if (!enabled.load(std::memory_order_relaxed)) return false;
+        return scoringCalls.fetch_add(1, std::memory_order_relaxed) % STAGE_SAMPLE_INTERVAL == 0;
+    }
+};
+
+extern EngineStats engineStats; // stats of every board in the process
+
+// times consecutive scoring stages of one call (does nothing unless the call is sampled)
+class StageTimer {
+    std::chrono::steady_clock::time_point last;
+    bool active;
+public:
+    StageTimer(bool active) : active(active) {
+        if (active) last = std::chrono::steady_clock::now();
+    }
+
+    // stores the time since the previous lap as the latest time of stage
+    inline void lap(ScoringStage stage) {
+        if (!active) return;
+        auto now = std::chrono::steady_clock::now();
+        engineStats.stageNanos[stage].store(std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count(), std::memory_order_relaxed);
+        last = now;
+    }
+};
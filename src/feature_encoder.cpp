@@ -0,0 +1,51 @@
+#include "feature_encoder.h"
+#include <algorithm>
+#include <cstring>
+
+void encodeBoard(const Board& board, int8_t playerIndex, BoardFeatures& features) {
+    std::memset(&features, 0, sizeof(features));
+    for (int s = 0; s < PLAYER_COUNT; ++s) {
+        const Player& player = board.players[(playerIndex + s) % PLAYER_COUNT];
+        const Hand& hand = player.hand;
+
+        // tiles by copy thresholds
+        for (uint64_t mask = hand.heldMask; mask; mask &= mask - 1) {
+            int t = std::countr_zero(mask);
+            for (int k = 0; k < hand.counts[t]; ++k)
+                features.hands[s][k][t] = 1;
+        }
+        for (int t = 0; t < TILE_TYPES; ++t)
+            for (int k = 0; k < hand.callCounts[t]; ++k)
+                features.melds[s][k][t] = 1;
+        for (int i = 0; i < MAX_HAND_SIZE; ++i)
+            if (hand.tiles[i].isRed())
+                features.redFives[s][TYPE_INDEX_MAP[*hand.tiles[i]]] = 1;
+
+        // river in discard order
+        int discards = std::min(player.discardCount, (int)FEATURE_RIVER_SLOTS);
+        for (int i = 0; i < discards; ++i) {
+            const Tile& tile = player.discards[i];
+            features.rivers[s][i][TYPE_INDEX_MAP[*tile]] = 1;
+            features.tsumogiri[s][i] = tile.getLastAction() == Tile::Action::Tsumogiri;
+            features.riichiDiscards[s][i] = player.riichiTurn && tile.getLastActionTurn() == player.riichiTurn;
+        }
+
+        features.scores[s] = player.score / 100000.0f;
+        features.riichi[s] = player.riichiTurn != 0;
+        for (int m = 0; m < hand.callMeldCount; ++m)
+            features.openHand[s] = features.openHand[s] || hand.callMelds[m].open();
+    }
+
+    // indicator i is paired with its uradora indicator at DORA_OFFSET + 2i
+    for (int i = 0; i < board.revealedDora && i < MAX_DORA_INDICATORS; ++i)
+        features.doraIndicators[i][TYPE_INDEX_MAP[*board.wall[DORA_OFFSET + (i << 1)]]] = 1;
+    features.roundWind[board.roundWind & 0b11] = 1;
+    features.seatWind[board.players[playerIndex].seatWind] = 1;
+    features.wallRemaining = board.wallRemaining() / (float)(TILE_COUNT - DEAD_WALL_SIZE - 13 * PLAYER_COUNT);
+    features.riichiSticks = board.riichiSticks;
+}
+
+void encodeBoards(const Board* boards, const int8_t* playerIndices, size_t count, BoardFeatures* features) {
+    for (size_t i = 0; i < count; ++i)
+        encodeBoard(boards[i], playerIndices[i], features[i]);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "board.h"
+
+const size_t FEATURE_RIVER_SLOTS = 24; // discards encoded per player (later discards are dropped)
+
+// fixed shape feature planes of a board seen from one player, written in place for a training batch
+// planes are rows of TILE_TYPES values indexed by type index, seats are relative to the encoded player (0 = self, 1 = next to act)
+// every hand is encoded (oracle view), imperfect information models should ignore hands[1..3]
+struct BoardFeatures {
+    float hands[PLAYER_COUNT][4][TILE_TYPES]; // closed tiles, plane k is set where the player holds more than k copies
+    float melds[PLAYER_COUNT][4][TILE_TYPES]; // call tiles, same thresholds as hands
+    float redFives[PLAYER_COUNT][TILE_TYPES]; // red fives held (closed or called)
+    float rivers[PLAYER_COUNT][FEATURE_RIVER_SLOTS][TILE_TYPES]; // one hot discard type per river slot in discard order
+    float tsumogiri[PLAYER_COUNT][FEATURE_RIVER_SLOTS]; // discard was the tile drawn that turn
+    float riichiDiscards[PLAYER_COUNT][FEATURE_RIVER_SLOTS]; // discard declared riichi
+    float doraIndicators[MAX_DORA_INDICATORS][TILE_TYPES]; // one hot per revealed indicator in reveal order
+    float roundWind[4]; // one hot
+    float seatWind[4]; // one hot
+    float scores[PLAYER_COUNT]; // points / 100000
+    float riichi[PLAYER_COUNT]; // riichi declared
+    float openHand[PLAYER_COUNT]; // has an open call meld
+    float wallRemaining; // live wall tiles left / 70
+    float riichiSticks; // deposits on the table
+};
+static_assert(sizeof(BoardFeatures) % sizeof(float) == 0 && std::is_standard_layout_v<BoardFeatures>, "features are read as a flat float array");
+
+const size_t FEATURE_SIZE = sizeof(BoardFeatures) / sizeof(float); // floats per encoded board
+
+void encodeBoard(const Board& board, int8_t playerIndex, BoardFeatures& features); // overwrites features with board seen from player
+void encodeBoards(const Board* boards, const int8_t* playerIndices, size_t count, BoardFeatures* features); // encodes a batch into consecutive features
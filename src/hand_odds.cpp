@@ -0,0 +1,469 @@
+#include "hand_odds.h"
+#include <bit>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+// counts packed 3 bits per type (at most 4 copies), keys the hand graph of drawOdds
+struct HandKey {
+    uint64_t low = 0; // type indices [0, 17)
+    uint64_t high = 0; // type indices [17, 34)
+    HandKey(const uint8_t counts[TILE_TYPES]) {
+        for (int i = 0; i < 17; ++i) {
+            low |= (uint64_t)counts[i] << (3 * i);
+            high |= (uint64_t)counts[17 + i] << (3 * i);
+        }
+    }
+    inline bool operator==(const HandKey& other) const {
+        return low == other.low && high == other.high;
+    }
+};
+
+struct HandKeyHash {
+    inline size_t operator()(const HandKey& key) const {
+        return (key.low * 0x9e3779b97f4a7c15ull) ^ (key.high * 0xc2b2ae3d27d4eb4full) ^ (key.high >> 29);
+    }
+};
+
+const int8_t NO_PAIR = -32; // part value without a pair to take (stays negative after adding any value)
+
+// best value (2 per group, 1 per partial group) of one part using at most b blocks (groups and partial groups), without and with the pair
+// regular shanten is 8 - 2 melds - (best value over the parts using at most MAX_GROUPS - melds blocks) - pair, and parts combine
+// by a max-plus product over blocks, so a hand never needs a search over all its tiles
+struct PartValue {
+    int8_t value[2][MAX_GROUPS + 1];
+};
+
+const int SHAPE_CACHE_BITS = 14; // hash buckets per thread (1 MiB with the ways)
+const int SHAPE_CACHE_WAYS = 4; // parts sharing a hash bucket (one cache line)
+const uint32_t HONOR_PART = 1u << 27; // key flag of the honor part (no runs)
+
+// cached part value, key is the packed counts of the part (empty entries hold an impossible key)
+struct PartEntry {
+    uint32_t key = UINT32_MAX;
+    PartValue part;
+};
+
+// parts with the same hash, most recently used first
+struct alignas(64) PartBucket {
+    PartEntry ways[SHAPE_CACHE_WAYS];
+};
+
+// part cache of the calling thread, fetched once per call since thread_local access is not free
+inline PartBucket* partCache() {
+    static thread_local std::vector<PartBucket> buckets(1 << SHAPE_CACHE_BITS);
+    return buckets.data();
+}
+
+// part of type index t (0 honors, then pin, sou, man) and where it starts
+inline int partOf(int t) {
+    return t < 7 ? 0 : 1 + (t - 7) / 9;
+}
+const int PART_START[4] = {0, 7, 16, 25};
+const int PART_SIZE[4] = {7, 9, 9, 9};
+
+// packed counts of one part (3 bits per type, honors flagged above them), one copy of t more or less is a single add
+inline uint32_t partKey(const uint8_t counts[TILE_TYPES], int part) {
+    uint32_t key = part ? 0 : HONOR_PART;
+    for (int i = 0; i < PART_SIZE[part]; ++i)
+        key |= counts[PART_START[part] + i] << (3 * i);
+    return key;
+}
+inline uint32_t typeKey(int t) {
+    return 1u << (3 * (t - PART_START[partOf(t)]));
+}
+
+inline PartValue partValue(PartBucket* cache, uint32_t key);
+
+// adds a block of weight (2 for a group, 1 for a partial group) to the best value of the rest of a part
+inline void addBlock(PartValue& best, const PartValue& rest, int weight) {
+    for (int pair = 0; pair <= 1; ++pair)
+        for (int blocks = 1; blocks <= MAX_GROUPS; ++blocks)
+            best.value[pair][blocks] = std::max<int>(best.value[pair][blocks], rest.value[pair][blocks - 1] + weight);
+}
+
+// value of a part by what its lowest type starts: a set, a run, a partial group, the pair or an isolated copy,
+// each leaving a smaller part that is looked up in turn, so parts share their sub searches through the cache
+PartValue searchPart(PartBucket* cache, uint32_t key) {
+    PartValue best;
+    for (int blocks = 0; blocks <= MAX_GROUPS; ++blocks) {
+        best.value[0][blocks] = 0;
+        best.value[1][blocks] = NO_PAIR;
+    }
+    uint32_t tiles = key & ~HONOR_PART;
+    if (!tiles) return best;
+    int i = std::countr_zero(tiles) / 3;
+    uint32_t one = 1u << (3 * i);
+    int count = (tiles >> (3 * i)) & 7;
+    bool runs = !(key & HONOR_PART);
+    bool next = runs && i + 1 < 9 && ((tiles >> (3 * (i + 1))) & 7);
+    bool after = runs && i + 2 < 9 && ((tiles >> (3 * (i + 2))) & 7);
+
+    best = partValue(cache, key - one); // isolated
+    if (count >= 2) {
+        PartValue rest = partValue(cache, key - 2 * one);
+        for (int blocks = 0; blocks <= MAX_GROUPS; ++blocks)
+            best.value[1][blocks] = std::max(best.value[1][blocks], rest.value[0][blocks]);
+        addBlock(best, rest, 1);
+    }
+    if (count >= 3) addBlock(best, partValue(cache, key - 3 * one), 2);
+    if (next && after) addBlock(best, partValue(cache, key - one - (one << 3) - (one << 6)), 2);
+    if (next) addBlock(best, partValue(cache, key - one - (one << 3)), 1);
+    if (after) addBlock(best, partValue(cache, key - one - (one << 6)), 1);
+    for (int blocks = 0; blocks <= MAX_GROUPS; ++blocks)
+        if (best.value[1][blocks] < 0) best.value[1][blocks] = NO_PAIR; // blocks added to a rest without the pair
+    return best;
+}
+
+// value of one part by its key, a hit is one cache line and a miss searches the part and evicts the least recently used way
+inline PartValue partValue(PartBucket* cache, uint32_t key) {
+    PartEntry* ways = cache[(key * 0x9e3779b1u) >> (32 - SHAPE_CACHE_BITS)].ways;
+    if (ways[0].key == key) return ways[0].part;
+    int way = 1;
+    while (way < SHAPE_CACHE_WAYS && ways[way].key != key) ++way;
+    PartEntry entry;
+    if (way == SHAPE_CACHE_WAYS) {
+        entry.part = searchPart(cache, key); // searched before touching the bucket, sub searches may reorder it
+        entry.key = key;
+        way = SHAPE_CACHE_WAYS - 1;
+    } else {
+        entry = ways[way];
+    }
+    for (; way > 0; --way)
+        ways[way] = ways[way - 1];
+    ways[0] = entry;
+    return entry.part;
+}
+
+// max-plus product of two parts (blocks add up, at most one pair)
+inline PartValue combine(const PartValue& a, const PartValue& b) {
+    PartValue c;
+    for (int blocks = 0; blocks <= MAX_GROUPS; ++blocks) {
+        int none = 0, pair = NO_PAIR;
+        for (int i = 0; i <= blocks; ++i) {
+            none = std::max(none, a.value[0][i] + b.value[0][blocks - i]);
+            pair = std::max({pair, a.value[1][i] + b.value[0][blocks - i], a.value[0][i] + b.value[1][blocks - i]});
+        }
+        c.value[0][blocks] = none;
+        c.value[1][blocks] = pair;
+    }
+    return c;
+}
+
+// regular shanten of the product of two parts (only the column of the allowed blocks is needed)
+inline int regularShanten(const PartValue& a, const PartValue& b, int melds) {
+    int blocks = MAX_GROUPS - melds;
+    int best = 0;
+    for (int i = 0; i <= blocks; ++i)
+        best = std::max({best, a.value[0][i] + b.value[0][blocks - i], a.value[1][i] + b.value[0][blocks - i] + 1, a.value[0][i] + b.value[1][blocks - i] + 1});
+    return 8 - 2 * melds - best;
+}
+
+const uint64_t ORPHAN_TYPES = 0x7f | 1ull << 7 | 1ull << 15 | 1ull << 16 | 1ull << 24 | 1ull << 25 | 1ull << 33; // honors and terminals
+
+// counts behind the 7 pairs and 13 orphans shanten (closed hands only), updated per tile
+struct SpecialCounts {
+    int pairs = 0; // types with 2+ copies
+    int kinds = 0; // types held
+    int orphans = 0; // orphan types held
+    int orphanPairs = 0; // orphan types with 2+ copies
+
+    SpecialCounts(const uint8_t counts[TILE_TYPES]) {
+        for (int t = 0; t < TILE_TYPES; ++t) {
+            int orphan = (ORPHAN_TYPES >> t) & 1;
+            pairs += counts[t] >= 2;
+            kinds += counts[t] > 0;
+            orphans += orphan & (counts[t] > 0);
+            orphanPairs += orphan & (counts[t] >= 2);
+        }
+    }
+
+    // moves type t from held count copies by delta (+1 or -1), call with the count before the move
+    inline void add(int t, int copies, int delta) {
+        int after = copies + delta;
+        int orphan = (ORPHAN_TYPES >> t) & 1;
+        int pair = (after >= 2) - (copies >= 2), kind = (after > 0) - (copies > 0);
+        pairs += pair;
+        kinds += kind;
+        orphans += orphan * kind;
+        orphanPairs += orphan * pair;
+    }
+
+    inline int pairShanten() const {
+        return 6 - pairs + std::max(0, 7 - kinds);
+    }
+
+    inline int orphanShanten() const {
+        return 13 - orphans - (orphanPairs > 0);
+    }
+
+    inline int shanten() const {
+        return std::min(pairShanten(), orphanShanten());
+    }
+};
+
+int shanten(const uint8_t counts[TILE_TYPES], int melds) {
+    PartBucket* cache = partCache();
+    PartValue low = combine(partValue(cache, partKey(counts, 0)), partValue(cache, partKey(counts, 1)));
+    int regular = regularShanten(low, combine(partValue(cache, partKey(counts, 2)), partValue(cache, partKey(counts, 3))), melds);
+    if (melds) return regular;
+    return std::min(regular, SpecialCounts(counts).shanten());
+}
+
+// products of every part but one folded into the column a changed part is matched against,
+// so changing a single part costs one lookup and a fixed max-plus over blocks
+struct PartProducts {
+    PartBucket* cache = partCache();
+    uint32_t keys[4];
+    int8_t columns[4][2][MAX_GROUPS + 1]; // best value of the other parts next to i blocks of part p, without and with the pair of p
+    int base; // 8 - 2 melds
+
+    PartProducts(const uint8_t counts[TILE_TYPES], int melds) : base(8 - 2 * melds) {
+        PartValue parts[4], others[4];
+        for (int part = 0; part < 4; ++part) {
+            keys[part] = partKey(counts, part);
+            parts[part] = partValue(cache, keys[part]);
+        }
+        PartValue low = combine(parts[0], parts[1]), high = combine(parts[2], parts[3]);
+        others[0] = combine(parts[1], high);
+        others[1] = combine(parts[0], high);
+        others[2] = combine(low, parts[3]);
+        others[3] = combine(low, parts[2]);
+        int blocks = MAX_GROUPS - melds;
+        for (int part = 0; part < 4; ++part)
+            for (int i = 0; i <= MAX_GROUPS; ++i) {
+                const PartValue& other = others[part];
+                columns[part][0][i] = i > blocks ? NO_PAIR : std::max(other.value[0][blocks - i], (int8_t)(other.value[1][blocks - i] + 1));
+                columns[part][1][i] = i > blocks ? NO_PAIR : other.value[0][blocks - i] + 1;
+            }
+    }
+
+    // regular shanten with one copy of t added (delta 1) or removed (delta -1)
+    inline int shanten(int t, int delta) const {
+        int part = partOf(t);
+        PartValue value = partValue(cache, keys[part] + delta * typeKey(t));
+        int none = 0, pair = 0; // two chains so the maxima overlap
+        for (int i = 0; i <= MAX_GROUPS; ++i) {
+            none = std::max(none, value.value[0][i] + columns[part][0][i]);
+            pair = std::max(pair, value.value[1][i] + columns[part][1][i]);
+        }
+        return base - std::max(none, pair);
+    }
+};
+
+// types whose draw can lower shanten below current: neighbours of held suited tiles and held honors, then for closed hands
+// orphans if 13 orphans is within one tile and new types if 7 pairs is within one tile and short of 7 kinds
+uint64_t drawCandidates(const uint8_t counts[TILE_TYPES], int melds, int current, const SpecialCounts& special) {
+    uint64_t held = 0;
+    for (int t = 0; t < TILE_TYPES; ++t)
+        held |= (uint64_t)(counts[t] > 0) << t;
+    uint64_t mask = held & 0x7f;
+    for (int suit = 7; suit < TILE_TYPES; suit += 9) {
+        uint64_t m = (held >> suit) & 0x1ff;
+        mask |= ((m | m << 1 | m >> 1 | m << 2 | m >> 2) & 0x1ff) << suit;
+    }
+    if (melds == 0) {
+        if (special.orphanShanten() <= current) mask |= ORPHAN_TYPES;
+        if (special.kinds < 7 && special.pairShanten() <= current) mask = (1ull << TILE_TYPES) - 1;
+    }
+    return mask;
+}
+
+void discardShanten(const uint8_t counts[TILE_TYPES], int melds, int8_t shantens[TILE_TYPES]) {
+    PartProducts products(counts, melds);
+    SpecialCounts special(counts);
+    int specialNow = melds ? 8 : special.shanten(); // a discard never lowers the special forms
+    uint64_t held = 0;
+    for (int t = 0; t < TILE_TYPES; ++t) {
+        shantens[t] = 8;
+        held |= (uint64_t)(counts[t] > 0) << t;
+    }
+    for (; held; held &= held - 1) {
+        int t = std::countr_zero(held);
+        int regular = products.shanten(t, -1);
+        if (specialNow < regular) {
+            special.add(t, counts[t], -1);
+            regular = std::min(regular, special.shanten());
+            special.add(t, counts[t] - 1, 1);
+        }
+        shantens[t] = regular;
+    }
+}
+
+int ukeire(const uint8_t counts[TILE_TYPES], int melds, const uint8_t unseen[TILE_TYPES], int current) {
+    PartProducts products(counts, melds);
+    SpecialCounts special(counts);
+    bool specialForms = !melds && special.shanten() <= current; // a draw lowers them by one at most
+    int tiles = 0;
+    for (uint64_t mask = drawCandidates(counts, melds, current, special); mask; mask &= mask - 1) {
+        int t = std::countr_zero(mask);
+        if (!unseen[t] || counts[t] == 4) continue;
+        int drawn = products.shanten(t, 1);
+        if (specialForms) {
+            special.add(t, counts[t], 1);
+            drawn = std::min(drawn, special.shanten());
+            special.add(t, counts[t] + 1, -1);
+        }
+        tiles += drawn < current ? unseen[t] : 0;
+    }
+    return tiles;
+}
+
+// hand graph of one drawOdds call, each 13 tile hand is expanded once into the draws lowering its shanten
+// and for each of them the discards keeping the lower shanten, odds per number of draws are then filled in over the graph
+struct OddsGraph {
+    struct Node {
+        uint8_t counts[TILE_TYPES];
+        int8_t shanten;
+        int16_t wall = 0; // tiles left to draw from
+        int16_t otherTiles = 0; // tiles left that do not lower shanten (discarded again)
+        int32_t firstDraw = -1; // -1 until expanded
+        int32_t drawCount = 0;
+        uint16_t solved = 0; // bit per number of draws
+        double tenpai[MAX_ODDS_DRAWS + 1];
+        double win[MAX_ODDS_DRAWS + 1];
+    };
+    struct Draw {
+        int16_t tiles; // copies left to draw
+        bool wins; // completes the hand
+        int32_t firstChild;
+        int32_t childCount; // hands after each discard keeping the lower shanten
+    };
+
+    const uint8_t* startCounts;
+    const uint8_t* unseen;
+    int melds;
+    std::vector<Node>& nodes;
+    std::vector<Draw>& draws;
+    std::vector<int32_t>& children;
+    std::unordered_map<HandKey, int32_t, HandKeyHash>& index;
+
+    // node of a hand, added unexpanded when new
+    int32_t node(const uint8_t counts[TILE_TYPES], int shanten) {
+        auto [entry, inserted] = index.try_emplace(HandKey(counts), (int32_t)nodes.size());
+        if (inserted) {
+            Node& added = nodes.emplace_back();
+            std::memcpy(added.counts, counts, sizeof(added.counts));
+            added.shanten = shanten;
+        }
+        return entry->second;
+    }
+
+    void expand(int32_t n) {
+        uint8_t counts[TILE_TYPES];
+        std::memcpy(counts, nodes[n].counts, sizeof(counts));
+        int current = nodes[n].shanten;
+
+        // wall left to draw from (tiles held beyond the starting hand came from it)
+        int16_t available[TILE_TYPES];
+        int wall = 0;
+        for (int t = 0; t < TILE_TYPES; ++t) {
+            available[t] = std::max(0, (int)unseen[t] - std::max(0, (int)counts[t] - (int)startCounts[t]));
+            wall += available[t];
+        }
+
+        int32_t firstDraw = draws.size();
+        int useful = 0;
+        for (uint64_t mask = drawCandidates(counts, melds, current, SpecialCounts(counts)); mask; mask &= mask - 1) {
+            int t = std::countr_zero(mask);
+            if (!available[t] || counts[t] == 4) continue;
+            ++counts[t];
+            int drawn = shanten(counts, melds);
+            if (drawn < current) {
+                Draw draw = {available[t], drawn == -1, (int32_t)children.size(), 0};
+                int8_t discards[TILE_TYPES];
+                if (drawn != -1) discardShanten(counts, melds, discards);
+                for (int d = 0; drawn != -1 && d < TILE_TYPES; ++d) {
+                    if (discards[d] != drawn || d == t) continue; // discarding the drawn type goes back to the hand
+                    --counts[d];
+                    children.push_back(node(counts, drawn));
+                    ++counts[d];
+                }
+                draw.childCount = children.size() - draw.firstChild;
+                draws.push_back(draw);
+                useful += available[t];
+            }
+            --counts[t];
+        }
+
+        Node& expanded = nodes[n];
+        expanded.wall = wall;
+        expanded.otherTiles = wall - useful;
+        expanded.firstDraw = firstDraw;
+        expanded.drawCount = draws.size() - firstDraw;
+    }
+
+    // fills odds of node n within k draws
+    void solve(int32_t n, int k, double& tenpai, double& win) {
+        int current = nodes[n].shanten;
+        tenpai = current == 0;
+        win = 0;
+        if (k == 0 || current > k) return;
+        if ((nodes[n].solved >> k) & 1) {
+            tenpai = nodes[n].tenpai[k];
+            win = nodes[n].win[k];
+            return;
+        }
+        if (nodes[n].firstDraw == -1) expand(n);
+        const int wall = nodes[n].wall;
+        if (wall == 0) return;
+
+        // draws lowering shanten are kept with the best discard for each objective
+        double tenpaiSum = 0, winSum = 0;
+        for (int32_t i = nodes[n].firstDraw, end = i + nodes[n].drawCount; i < end; ++i) {
+            Draw draw = draws[i];
+            double chance = (double)draw.tiles / wall;
+            if (draw.wins) {
+                tenpaiSum += chance;
+                winSum += chance;
+                continue;
+            }
+            if (current - 1 > k - 1) continue;
+            double bestTenpai = 0, bestWin = 0;
+            for (int32_t c = draw.firstChild; c < draw.firstChild + draw.childCount; ++c) {
+                double childTenpai, childWin;
+                solve(children[c], k - 1, childTenpai, childWin);
+                bestTenpai = std::max(bestTenpai, childTenpai);
+                bestWin = std::max(bestWin, childWin);
+            }
+            tenpaiSum += chance * bestTenpai;
+            winSum += chance * bestWin;
+        }
+
+        // any other draw is discarded again
+        double otherTenpai = 0, otherWin = 0;
+        if (nodes[n].otherTiles) solve(n, k - 1, otherTenpai, otherWin);
+        double other = (double)nodes[n].otherTiles / wall;
+        tenpai = current == 0 ? 1 : tenpaiSum + other * otherTenpai;
+        win = winSum + other * otherWin;
+
+        Node& solved = nodes[n];
+        solved.tenpai[k] = tenpai;
+        solved.win[k] = win;
+        solved.solved |= 1 << k;
+    }
+};
+
+DrawOdds drawOdds(const uint8_t counts[TILE_TYPES], int melds, const uint8_t unseen[TILE_TYPES], int draws) {
+    // graph buffers reused between calls (the graph depends on unseen and the starting hand)
+    static thread_local std::vector<OddsGraph::Node> nodes;
+    static thread_local std::vector<OddsGraph::Draw> graphDraws;
+    static thread_local std::vector<int32_t> children;
+    static thread_local std::unordered_map<HandKey, int32_t, HandKeyHash> index;
+    nodes.clear();
+    graphDraws.clear();
+    children.clear();
+    index.clear();
+
+    OddsGraph graph{counts, unseen, melds, nodes, graphDraws, children, index};
+    int32_t root = graph.node(counts, shanten(counts, melds));
+    DrawOdds odds;
+    draws = std::min(draws, MAX_ODDS_DRAWS);
+    for (int k = 0; k <= draws; ++k) {
+        double tenpai, win;
+        graph.solve(root, k, tenpai, win);
+        odds.tenpai[k] = tenpai;
+        odds.win[k] = win;
+    }
+    return odds;
+}
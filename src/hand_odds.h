@@ -0,0 +1,30 @@
+#pragma once
+
+#include "board.h"
+
+const int MAX_ODDS_DRAWS = 8; // most self draws drawOdds looks ahead
+
+// chance of reaching tenpai and of completing the hand within 0..draws self draws
+// index k is the chance within k draws (index 0 is the current hand, so 0 or 1)
+struct DrawOdds {
+    float tenpai[MAX_ODDS_DRAWS + 1] = {};
+    float win[MAX_ODDS_DRAWS + 1] = {};
+};
+
+// tiles away from tenpai of closed counts (13 or 14 tiles less 3 per call meld), 0 is tenpai, -1 is complete
+// tenpai is by shape, a hand waiting only on types it holds all 4 of still counts as 0
+// minimum over groups and pair, 7 pairs and 13 orphans (the last two for closed hands only)
+int shanten(const uint8_t counts[TILE_TYPES], int melds);
+
+// shanten after discarding each held type of a 14 tile hand (8 for types not held), parts a discard leaves alone are shared
+void discardShanten(const uint8_t counts[TILE_TYPES], int melds, int8_t shantens[TILE_TYPES]);
+
+// unseen tiles whose draw lowers the shanten (current) of a 13 tile hand, effective tiles / ukeire
+int ukeire(const uint8_t counts[TILE_TYPES], int melds, const uint8_t unseen[TILE_TYPES], int current);
+
+// exact odds of a 13 tile hand (closed counts, melds call melds) drawing from unseen tiles (Board::unseenCounts, dynamic programming, no sampling)
+// the hand plays the shortest way to a win: a draw that lowers shanten is kept with the best discard keeping the lower shanten,
+// any other draw is discarded again, and the tenpai and win odds are each maximized over discards
+// draws come uniformly from the unseen tiles, less tiles the hand holds beyond its starting counts (hands are keyed on counts alone,
+// so a tile drawn and discarded again is treated as back in the wall), and the wall is assumed to last all draws
+DrawOdds drawOdds(const uint8_t counts[TILE_TYPES], int melds, const uint8_t unseen[TILE_TYPES], int draws);
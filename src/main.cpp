@@ -1,12 +1,15 @@
 #include <SFML/Graphics.hpp>
 #include <iostream>
 #include "board.h"
+#include "agari.h"
 #include "view.h"
 
 int main()
 {
     initDoraMap();
     View::init();
+    if (!AgariTable::load("resources/agari.bin"))
+        std::cout << "agari table not found, searching decompositions" << std::endl;
 
     Tile tiles[MAX_HAND_SIZE] = {
         Tile(PIN9),
@@ -32,11 +35,13 @@ int main()
     };
     Board board;
     memcpy(board.players[0].hand.tiles, tiles, sizeof(tiles));
+    board.players[0].hand.recount();
     board.players[0].riichiTurn = 1;
     ScoreInfo scoreInfo = board.valueOfHand(0);
     std::cout << "basic points=" << scoreInfo.basicPoints() << std::endl;
-    for (auto& [yaku, han] : scoreInfo.yakuHan) {
-        std::cout << YAKU_INFO_MAP[yaku].name << " " << han << std::endl;
+    for (int yaku = 0; yaku < YAKU_COUNT; ++yaku) {
+        if (scoreInfo.hasYaku((Yaku)yaku))
+            std::cout << YAKU_INFO_MAP[yaku].name << " " << scoreInfo.yakuHan[yaku] << std::endl;
     }
 
     View view(board);
@@ -46,6 +51,8 @@ int main()
         for (auto event = sf::Event{}; view.window.pollEvent(event);) {
             if (event.type == sf::Event::Closed) {
                 view.window.close();
+            } else if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F3) {
+                view.setShowStats(!view.showStats); // performance overlay
             }
         }
 
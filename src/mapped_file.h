@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+// read-only memory mapping of a whole file
+// pages are shared through the os page cache, so many processes mapping the same file share one copy
+class MappedFile {
+    const uint8_t* _data = nullptr;
+    size_t _size = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+public:
+    MappedFile() {}
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    bool open(const std::string& path); // maps file, returns false if it cannot be opened or is empty
+    void close(); // unmaps file
+    inline const uint8_t* data() const { return _data; }
+    inline size_t size() const { return _size; }
+};
@@ -0,0 +1,90 @@
+#include "score_protocol.h"
+#include <cstring>
+
+// whether tile code is empty or a valid type (red flag only on fives)
+inline bool validTile(uint8_t tile) {
+    TileType type = tile & 0b111111;
+    if (type == NONE) return tile == NONE;
+    return TYPE_INDEX_MAP[type] != -1 && (!(tile >> 6) || ((type >> 4) && (type & 0b1111) == 5)) && tile >> 7 == 0;
+}
+
+// whether a record holds a winning sized hand with well formed call melds and at most 4 copies per type
+bool validHand(const CorpusRecord& record) {
+    if (record.callMeldCount < 0 || record.callMeldCount > MAX_GROUPS || record.callTiles < 0 || record.callTiles > DRAWN_I) return false;
+    uint8_t counts[TILE_TYPES] = {};
+    int closedTiles = 0;
+    for (int i = 0; i < MAX_HAND_SIZE; ++i) {
+        uint8_t tile = record.tiles[i];
+        if (!validTile(tile) || (i < record.callTiles && tile == NONE)) return false;
+        if (tile == NONE) continue;
+        if (++counts[TYPE_INDEX_MAP[tile & 0b111111]] > 4) return false;
+        closedTiles += i >= record.callTiles;
+    }
+    if (record.tiles[DRAWN_I] == NONE || closedTiles != 14 - 3 * record.callMeldCount) return false;
+
+    // melds are consecutive call tiles, each a triplet, a kan or a run in order
+    int index = 0;
+    for (int m = 0; m < record.callMeldCount; ++m) {
+        int size = record.melds[m] & 0b111;
+        if (size != 3 && size != 4) return false;
+        const uint8_t* tiles = record.tiles + index;
+        index += size;
+        if (index > record.callTiles) return false;
+        TileType first = tiles[0] & 0b111111;
+        bool same = true;
+        bool run = size == 3 && (first >> 4) != 0;
+        for (int k = 1; k < size; ++k) {
+            TileType type = tiles[k] & 0b111111;
+            same &= type == first;
+            run &= type == first + k;
+        }
+        if (!same && !run) return false;
+    }
+    return index == record.callTiles;
+}
+
+void scoreRequests(Board& board, const ScoreRequest* requests, size_t count, ScoreResponse* responses) {
+    Player& player = board.players[0];
+    for (size_t r = 0; r < count; ++r) {
+        const ScoreRequest& request = requests[r];
+        ScoreResponse& response = responses[r];
+        response.id = request.id;
+        response.score = ScoreInfo();
+        if (request.version != SCORE_PROTOCOL_VERSION) {
+            response.status = ScoreBadVersion;
+            continue;
+        }
+        bool valid = validHand(request.hand) && request.roundWind >= 0 && request.roundWind < 4 && request.seatWind >= 0 && request.seatWind < 4;
+        for (int i = 0; i < MAX_DORA_INDICATORS; ++i)
+            valid = valid && validTile(request.doraIndicators[i]) && validTile(request.uradoraIndicators[i]);
+        if (!valid) {
+            response.status = ScoreInvalidHand;
+            continue;
+        }
+
+        // context
+        board.roundWind = request.roundWind;
+        player.seatWind = request.seatWind;
+        board.lastCallTurn = 0;
+        std::memset(board.doraCounts, 0, sizeof(board.doraCounts));
+        std::memset(board.uradoraCounts, 0, sizeof(board.uradoraCounts));
+        for (int i = 0; i < MAX_DORA_INDICATORS; ++i) {
+            if (request.doraIndicators[i] != NONE) ++board.doraCounts[TYPE_INDEX_MAP[DORA_MAP[request.doraIndicators[i] & 0b111111]]];
+            if (request.uradoraIndicators[i] != NONE) ++board.uradoraCounts[TYPE_INDEX_MAP[DORA_MAP[request.uradoraIndicators[i] & 0b111111]]];
+        }
+
+        // riichi turns are placed so the scoring checks see (double) riichi and ippatsu as requested
+        loadHand(request.hand, player.hand);
+        bool riichi = request.flags & (SCORE_RIICHI | SCORE_DOUBLE_RIICHI);
+        player.ronActive = request.flags & SCORE_RON;
+        player.discardMask = 0;
+        player.tempFuriten = false;
+        player.riichiFuriten = false;
+        player.firstTurn = 1;
+        player.riichiTurn = riichi ? (request.flags & SCORE_DOUBLE_RIICHI ? 1 : 2) : 0;
+        player.lastTurn = riichi && (request.flags & SCORE_IPPATSU) ? player.riichiTurn : player.riichiTurn + 1;
+
+        response.status = ScoreOk;
+        response.score = board.valueOfHand(0);
+    }
+}
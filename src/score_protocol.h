@@ -0,0 +1,47 @@
+#pragma once
+
+#include "board.h"
+#include "corpus.h"
+
+/* scoring protocol (native endianness, fixed size messages over a stream socket)
+    client sends ScoreRequest messages back to back, server answers each with a ScoreResponse
+    responses on a connection come back in request order, id is echoed so clients may pipeline
+*/
+
+const uint32_t SCORE_PROTOCOL_VERSION = 1; // bump when message layout changes
+
+// request flags
+const uint8_t SCORE_RON = 1 << 0; // win on a discard (otherwise self draw)
+const uint8_t SCORE_RIICHI = 1 << 1; // hand declared riichi (uradora counted)
+const uint8_t SCORE_DOUBLE_RIICHI = 1 << 2; // riichi declared on the first uninterrupted turn
+const uint8_t SCORE_IPPATSU = 1 << 3; // win within one uninterrupted turn of riichi
+
+// response status
+enum ScoreStatus : uint32_t {
+    ScoreOk,
+    ScoreInvalidHand, // malformed tiles or melds, score is empty
+    ScoreBadVersion // request version differs from the server's, score is empty
+};
+
+struct ScoreRequest {
+    uint32_t id; // echoed in the response
+    uint16_t version; // SCORE_PROTOCOL_VERSION
+    uint8_t flags; // request flags
+    int8_t roundWind; // 0-3 (east to north)
+    int8_t seatWind; // 0-3 (east to north)
+    uint8_t doraIndicators[MAX_DORA_INDICATORS]; // revealed indicator tile types, NONE for unrevealed
+    uint8_t uradoraIndicators[MAX_DORA_INDICATORS]; // uradora indicator tile types (used with riichi), NONE for unrevealed
+    uint8_t reserved; // explicit padding
+    CorpusRecord hand; // winning hand, winning tile in the drawn slot (kind is ignored)
+};
+
+struct ScoreResponse {
+    uint32_t id; // request id
+    ScoreStatus status;
+    ScoreInfo score;
+};
+static_assert(sizeof(ScoreRequest) == 52 && std::has_unique_object_representations_v<ScoreRequest>);
+static_assert(std::is_trivially_copyable_v<ScoreRequest> && std::is_trivially_copyable_v<ScoreResponse>, "messages are sent as raw bytes");
+
+// scores a batch of requests on one warm board (overwrites its winds, dora tables and first player)
+void scoreRequests(Board& board, const ScoreRequest* requests, size_t count, ScoreResponse* responses);
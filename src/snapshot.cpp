@@ -0,0 +1,81 @@
+#include "snapshot.h"
+#include <cstdio>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// flushes a written file through to disk
+bool syncFile(FILE* file) {
+    if (fflush(file) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+// makes a rename into directory durable (windows has no directory handle to sync)
+bool syncDirectory(const std::filesystem::path& directory) {
+#ifdef _WIN32
+    return true;
+#else
+    int fd = open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return false;
+    bool synced = fsync(fd) == 0;
+    close(fd);
+    return synced;
+#endif
+}
+
+void SnapshotWriter::save(const std::string& path, const Board* boards, const int32_t* roundsLeft, size_t count) {
+    wait();
+    SnapshotHeader header = {};
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.boardSize = sizeof(Board);
+    header.tableCount = count;
+    buffer.resize(sizeof(header) + count * (sizeof(Board) + sizeof(int32_t)));
+    uint8_t* data = buffer.data();
+    memcpy(data, &header, sizeof(header));
+    memcpy(data + sizeof(header), boards, count * sizeof(Board));
+    memcpy(data + sizeof(header) + count * sizeof(Board), roundsLeft, count * sizeof(int32_t));
+    thread = std::thread(&SnapshotWriter::write, this, path);
+}
+
+void SnapshotWriter::write(std::string path) {
+    std::string partial = path + ".partial";
+    FILE* file = fopen(partial.c_str(), "wb");
+    bool written = file && fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size() && syncFile(file);
+    if (file) written &= fclose(file) == 0;
+
+    // the data is on disk before the rename replaces the previous snapshot, and the rename itself is synced with its directory
+    std::error_code error;
+    if (written) std::filesystem::rename(partial, path, error);
+    ok &= written && !error && syncDirectory(std::filesystem::path(path).parent_path());
+}
+
+bool SnapshotWriter::wait() {
+    if (thread.joinable()) thread.join();
+    return ok;
+}
+
+bool loadSnapshot(const std::string& path, std::vector<Board>& boards, std::vector<int32_t>& roundsLeft) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+    SnapshotHeader header;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 && memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0
+        && header.version == SNAPSHOT_VERSION && header.boardSize == sizeof(Board);
+    if (valid) {
+        boards.resize(header.tableCount);
+        roundsLeft.resize(header.tableCount);
+        valid = fread(boards.data(), sizeof(Board), header.tableCount, file) == header.tableCount
+            && fread(roundsLeft.data(), sizeof(int32_t), header.tableCount, file) == header.tableCount;
+    }
+    fclose(file);
+    return valid;
+}
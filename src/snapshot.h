@@ -0,0 +1,44 @@
+#pragma once
+
+#include "board.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+/* table snapshot file (native endianness, only read back by the same build)
+    SnapshotHeader, then Board[tableCount] as raw bytes, then int32_t roundsLeft[tableCount]
+    boards are trivially copyable (wall rng included), so saving and loading is a bulk copy
+    boardSize must match sizeof(Board), so snapshots from a build with another board layout are rejected
+*/
+
+const char SNAPSHOT_MAGIC[4] = {'R', 'S', 'N', 'P'};
+const uint32_t SNAPSHOT_VERSION = 1; // bump when file layout changes
+
+struct SnapshotHeader {
+    char magic[4]; // SNAPSHOT_MAGIC
+    uint32_t version; // SNAPSHOT_VERSION
+    uint32_t boardSize; // sizeof(Board)
+    uint32_t reserved;
+    uint64_t tableCount;
+};
+static_assert(std::is_trivially_copyable_v<Board>, "boards are saved as raw bytes");
+
+// writes snapshots on a background thread, save only blocks to copy the tables (and on a previous write still in flight)
+// files are written next to path, synced and renamed over it once complete, so an interrupted write or a crash keeps the previous snapshot
+class SnapshotWriter {
+    std::vector<uint8_t> buffer; // header and tables of the snapshot being written
+    std::thread thread;
+    bool ok = true;
+
+    void write(std::string path); // writer thread
+public:
+    SnapshotWriter() {}
+    ~SnapshotWriter() { wait(); }
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+    void save(const std::string& path, const Board* boards, const int32_t* roundsLeft, size_t count); // copies tables and starts writing them
+    bool wait(); // waits for the write in flight, returns whether every write so far succeeded
+};
+
+// reads a snapshot written by SnapshotWriter, returns false if it is missing or does not match this build
+bool loadSnapshot(const std::string& path, std::vector<Board>& boards, std::vector<int32_t>& roundsLeft);
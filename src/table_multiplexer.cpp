@@ -0,0 +1,132 @@
+#include "table_multiplexer.h"
+#include <thread>
+
+TableTask playTable(TableMultiplexer& multiplexer, Board& board, int32_t& roundsLeft) {
+    Decision decisions[PLAYER_COUNT];
+    for (; roundsLeft > 0; --roundsLeft) {
+        if (board.phase == Board::EndPhase) board.nextRound(); // restored tables may be mid round
+        while (board.phase != Board::EndPhase) {
+            // every player with a decision is asked at once, so a call phase is one batch entry per caller
+            int count = 0;
+            for (int i = 1; i <= PLAYER_COUNT; ++i) {
+                int8_t p = (board.currentPlayer + i) % PLAYER_COUNT; // turn order after the discarder, current player last
+                Decision& decision = decisions[count];
+                board.legalActions(p, decision.actions);
+                if (!decision.actions.size()) continue;
+                decision.board = &board;
+                decision.player = p;
+                decision.choice = 0;
+                ++count;
+            }
+            co_await multiplexer.decide(decisions, count);
+
+            // highest priority choice wins, ties go to the first player in turn order
+            Action action = decisions[0].actions[decisions[0].choice];
+            for (int d = 1; d < count; ++d) {
+                const Action& chosen = decisions[d].actions[decisions[d].choice];
+                if (callPriority(chosen.type) > callPriority(action.type)) action = chosen;
+            }
+            board.step(action);
+        }
+    }
+}
+
+void TableMultiplexer::submit(std::coroutine_handle<> table, Decision* tableDecisions, int count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.push_back({table, tableDecisions, count});
+    pendingDecisions += count;
+    --running;
+    if (pendingDecisions >= maxBatch || (running == 0 && ready.empty())) wake.notify_one();
+}
+
+void TableMultiplexer::retire(std::coroutine_handle<> table) {
+    table.destroy();
+    std::lock_guard<std::mutex> lock(mutex);
+    --running;
+    --activeTables;
+    wake.notify_all();
+}
+
+void TableMultiplexer::work() {
+    std::vector<PendingTable> batch;
+    std::vector<Decision*> batchDecisions;
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        if (!ready.empty()) {
+            std::coroutine_handle<> table = ready.front();
+            ready.pop_front();
+            ++running;
+            lock.unlock();
+            table.resume(); // returns once the table is parked or retired (another worker may already own it)
+            lock.lock();
+            continue;
+        }
+        if (activeTables == 0) break;
+
+        // run the policy once the batch is full or nothing else can make progress
+        if (!flushing && !pending.empty() && (pendingDecisions >= maxBatch || running == 0)) {
+            flushing = true;
+            batch.swap(pending);
+            pendingDecisions = 0;
+
+            // every unfinished table is parked in this batch before its decision is applied, so the boards are a consistent snapshot
+            bool snapshot = checkpointInterval && running == 0 && ready.empty() && batches - lastCheckpoint >= checkpointInterval;
+            lock.unlock();
+            if (snapshot) {
+                snapshots.save(checkpointPath, boards.data(), roundsLeft.data(), boards.size());
+                lastCheckpoint = batches;
+            }
+            batchDecisions.clear();
+            for (PendingTable& table : batch)
+                for (int d = 0; d < table.count; ++d)
+                    batchDecisions.push_back(table.decisions + d);
+            policy(batchDecisions.data(), batchDecisions.size());
+            lock.lock();
+            for (PendingTable& table : batch)
+                ready.push_back(table.table);
+            ++batches;
+            decisions += batchDecisions.size();
+            batch.clear();
+            flushing = false;
+            wake.notify_all();
+            continue;
+        }
+        wake.wait(lock);
+    }
+    wake.notify_all();
+}
+
+void TableMultiplexer::checkpoint(const std::string& path, size_t interval) {
+    checkpointPath = path;
+    checkpointInterval = interval;
+}
+
+void TableMultiplexer::run(int tables, int rounds) {
+    boards.resize(tables);
+    roundsLeft.assign(tables, rounds);
+    for (int t = 0; t < tables; ++t) {
+        boards[t].random.seed(t); // distinct walls per table
+        boards[t].initGame();
+    }
+    resume();
+}
+
+void TableMultiplexer::resume() {
+    lastCheckpoint = batches;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t t = 0; t < boards.size(); ++t) {
+            if (roundsLeft[t] <= 0) continue;
+            TableTask task = playTable(*this, boards[t], roundsLeft[t]);
+            task.handle.promise().multiplexer = this;
+            ready.push_back(task.handle);
+            ++activeTables;
+        }
+    }
+    std::vector<std::thread> workers;
+    for (int w = 1; w < workerCount; ++w)
+        workers.emplace_back(&TableMultiplexer::work, this);
+    work();
+    for (std::thread& worker : workers) worker.join();
+    if (checkpointInterval) snapshots.save(checkpointPath, boards.data(), roundsLeft.data(), boards.size()); // finished tables, a restart has nothing left to play
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "board.h"
+#include "snapshot.h"
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+class TableMultiplexer;
+
+// decision a table waits on, the policy sets choice to an index into actions
+struct Decision {
+    const Board* board = nullptr;
+    int8_t player = -1;
+    ActionList actions; // legal actions (never empty)
+    int choice = 0;
+};
+
+// batch policy, called with every decision gathered in one round (never called concurrently)
+typedef std::function<void(Decision* const* decisions, size_t count)> BatchPolicy;
+
+// coroutine of one table, started and resumed by the multiplexer's workers
+class TableTask {
+public:
+    struct promise_type {
+        TableMultiplexer* multiplexer = nullptr;
+        TableTask get_return_object() { return TableTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept; // retires the table (frame destroyed by the awaiter)
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+    std::coroutine_handle<promise_type> handle;
+    explicit TableTask(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+};
+
+// plays many tables on a few worker threads, each table suspends while its decisions wait for the batch policy
+// tables run until they need a decision, decisions are sent to the policy once maxBatch are pending or every table is waiting
+class TableMultiplexer {
+    struct PendingTable {
+        std::coroutine_handle<> table;
+        Decision* decisions;
+        int count;
+    };
+
+    BatchPolicy policy;
+    int workerCount;
+    size_t maxBatch;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::coroutine_handle<>> ready; // tables to resume
+    std::vector<PendingTable> pending; // tables waiting on the policy
+    size_t pendingDecisions = 0;
+    int running = 0; // tables being resumed by a worker
+    int activeTables = 0; // tables not yet finished
+    bool flushing = false; // a worker is running the policy
+    size_t batches = 0;
+    size_t decisions = 0;
+    std::string checkpointPath;
+    size_t checkpointInterval = 0; // batches between snapshots, 0 if disabled
+    size_t lastCheckpoint = 0; // batch count at the last snapshot
+    SnapshotWriter snapshots;
+
+    void work(); // worker loop
+    void submit(std::coroutine_handle<> table, Decision* decisions, int count); // parks table until its decisions are made
+    void retire(std::coroutine_handle<> table); // destroys a finished table
+public:
+    std::vector<Board> boards; // one board per table, readable once run returns
+    std::vector<int32_t> roundsLeft; // rounds each table still has to finish (a table mid round counts its current round)
+
+    TableMultiplexer(BatchPolicy policy, int workerCount, size_t maxBatch) : policy(std::move(policy)), workerCount(workerCount), maxBatch(maxBatch) {}
+    void run(int tables, int rounds); // deals fresh tables and plays rounds on each, returns once every table is done
+    void resume(); // plays the tables in boards and roundsLeft (e.g. filled by loadSnapshot) to the end
+    void checkpoint(const std::string& path, size_t interval); // snapshots every table to path every interval batches (0 disables)
+    inline bool checkpointsWritten() { return snapshots.wait(); } // waits for the last snapshot, returns whether every snapshot was written
+    inline size_t batchCount() const { return batches; }
+    inline size_t decisionCount() const { return decisions; }
+
+    // awaitable that suspends a table until the policy has decided for every given decision
+    struct DecisionAwaiter {
+        TableMultiplexer& multiplexer;
+        Decision* decisions;
+        int count;
+        bool await_ready() const noexcept { return count == 0; }
+        void await_suspend(std::coroutine_handle<> table) { multiplexer.submit(table, decisions, count); }
+        void await_resume() const noexcept {}
+    };
+    inline DecisionAwaiter decide(Decision* decisions, int count) { return {*this, decisions, count}; }
+
+    friend struct TableTask::promise_type;
+};
+
+inline auto TableTask::promise_type::final_suspend() noexcept {
+    struct Retire {
+        TableMultiplexer* multiplexer;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> table) noexcept { multiplexer->retire(table); }
+        void await_resume() const noexcept {}
+    };
+    return Retire{multiplexer};
+}
+
+TableTask playTable(TableMultiplexer& multiplexer, Board& board, int32_t& roundsLeft); // table coroutine (finishes the current round, then deals the rest)
@@ -0,0 +1,229 @@
+#include "tournament.h"
+#include <cstring>
+
+EntryStats& EntryStats::operator+=(const EntryStats& other) {
+    games += other.games;
+    rounds += other.rounds;
+    wins += other.wins;
+    tsumoWins += other.tsumoWins;
+    dealIns += other.dealIns;
+    for (int i = 0; i < PLAYER_COUNT; ++i)
+        ranks[i] += other.ranks[i];
+    scoreSum += other.scoreSum;
+    scoreSquareSum += other.scoreSquareSum;
+    rankSum += other.rankSum;
+    rankSquareSum += other.rankSquareSum;
+    return *this;
+}
+
+TournamentStats& TournamentStats::operator+=(const TournamentStats& other) {
+    for (int i = 0; i < PLAYER_COUNT; ++i)
+        entries[i] += other.entries[i];
+    return *this;
+}
+
+uint64_t gameSeed(uint64_t seed, uint64_t game) {
+    uint64_t z = seed + (game + 1) * 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+bool RoundWriter::open(const std::string& path) {
+    close();
+    file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+    csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+    if (csv) {
+        fputs("game,round,dealer,winner,loser,han,fu,yaku_mask", file);
+        for (int i = 0; i < PLAYER_COUNT; ++i)
+            fprintf(file, ",score%d", i);
+        fputc('\n', file);
+    } else {
+        TournamentFileHeader header = {};
+        memcpy(header.magic, TOURNAMENT_MAGIC, sizeof(header.magic));
+        header.version = TOURNAMENT_VERSION;
+        header.playerCount = PLAYER_COUNT;
+        fwrite(&header, sizeof(header), 1, file);
+    }
+    closing = false;
+    thread = std::thread(&RoundWriter::work, this);
+    return true;
+}
+
+void RoundWriter::close() {
+    if (!file) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = true;
+    }
+    wake.notify_one();
+    thread.join();
+    fclose(file);
+    file = nullptr;
+}
+
+void RoundWriter::submit(std::vector<RoundRecord>& rows) {
+    std::unique_lock<std::mutex> lock(mutex);
+    space.wait(lock, [&] { return queued.size() < maxQueued; });
+    queued.push_back(std::move(rows));
+    rows = std::vector<RoundRecord>();
+    if (!spare.empty()) {
+        rows.swap(spare.back());
+        spare.pop_back();
+    }
+    rows.clear();
+    wake.notify_one();
+}
+
+void RoundWriter::work() {
+    std::vector<std::vector<RoundRecord>> writing;
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [&] { return !queued.empty() || closing; });
+        if (queued.empty()) break;
+        writing.swap(queued);
+        space.notify_all();
+        lock.unlock();
+        for (const std::vector<RoundRecord>& rows : writing)
+            write(rows);
+        lock.lock();
+        for (std::vector<RoundRecord>& rows : writing)
+            if (spare.size() < maxQueued) spare.push_back(std::move(rows));
+        writing.clear();
+    }
+    fflush(file);
+}
+
+// appends one column of a block
+template <typename T, typename Field>
+void appendColumn(std::vector<uint8_t>& block, const std::vector<RoundRecord>& rows, Field field) {
+    size_t offset = block.size();
+    block.resize(offset + rows.size() * sizeof(T));
+    for (size_t i = 0; i < rows.size(); ++i) {
+        T value = field(rows[i]);
+        memcpy(block.data() + offset + i * sizeof(T), &value, sizeof(T));
+    }
+}
+
+void RoundWriter::write(const std::vector<RoundRecord>& rows) {
+    if (csv) {
+        for (const RoundRecord& row : rows) {
+            fprintf(file, "%llu,%d,%d,%d,%d,%d,%d,%llu", (unsigned long long)row.game, row.round, row.dealer, row.winner, row.loser, row.han, row.fu, (unsigned long long)row.yakuMask);
+            for (int i = 0; i < PLAYER_COUNT; ++i)
+                fprintf(file, ",%d", row.scores[i]);
+            fputc('\n', file);
+        }
+        return;
+    }
+
+    uint32_t count = rows.size();
+    block.resize(sizeof(count));
+    memcpy(block.data(), &count, sizeof(count));
+    appendColumn<uint64_t>(block, rows, [](const RoundRecord& row) { return row.game; });
+    appendColumn<uint8_t>(block, rows, [](const RoundRecord& row) { return row.round; });
+    appendColumn<int8_t>(block, rows, [](const RoundRecord& row) { return row.dealer; });
+    appendColumn<int8_t>(block, rows, [](const RoundRecord& row) { return row.winner; });
+    appendColumn<int8_t>(block, rows, [](const RoundRecord& row) { return row.loser; });
+    appendColumn<int16_t>(block, rows, [](const RoundRecord& row) { return row.han; });
+    appendColumn<int16_t>(block, rows, [](const RoundRecord& row) { return row.fu; });
+    appendColumn<uint64_t>(block, rows, [](const RoundRecord& row) { return row.yakuMask; });
+    for (int i = 0; i < PLAYER_COUNT; ++i)
+        appendColumn<int32_t>(block, rows, [i](const RoundRecord& row) { return row.scores[i]; });
+    fwrite(block.data(), 1, block.size(), file);
+}
+
+void Tournament::work(int worker, size_t games, int rounds, uint64_t seed, RoundWriter* writer) {
+    const size_t GAME_BATCH = 16; // games taken from the shared counter at once
+    TournamentStats& stats = workerStats[worker];
+    Board board;
+    ActionList actions;
+    std::vector<RoundRecord> rows;
+    for (;;) {
+        size_t first = nextGame.fetch_add(GAME_BATCH, std::memory_order_relaxed);
+        if (first >= games) break;
+        for (size_t game = first; game < std::min(games, first + GAME_BATCH); ++game) {
+            int scores[PLAYER_COUNT]; // by entry
+            std::fill(scores, scores + PLAYER_COUNT, 25000);
+            // consecutive games replay the same walls with the entries rotated one seat
+            board.random.seed(gameSeed(seed, game / PLAYER_COUNT));
+            board.initGame();
+            auto entry = [&](int seat) { return (int8_t)((game + seat) % PLAYER_COUNT); };
+            for (int seat = 0; seat < PLAYER_COUNT; ++seat)
+                board.players[seat].score = scores[entry(seat)];
+            for (int round = 0; round < rounds; ++round) {
+                if (round) board.nextRound(); // the board passes the deal to the next seat
+
+                // every player with a decision is asked, highest priority choice wins with ties to the first in turn order
+                while (board.phase != Board::EndPhase) {
+                    Action action;
+                    bool decided = false;
+                    for (int i = 1; i <= PLAYER_COUNT; ++i) {
+                        int8_t p = (board.currentPlayer + i) % PLAYER_COUNT;
+                        board.legalActions(p, actions);
+                        if (!actions.size()) continue;
+                        const Action& chosen = actions[policies[entry(p)](board, p, actions)];
+                        if (!decided || callPriority(chosen.type) > callPriority(action.type)) action = chosen;
+                        decided = true;
+                    }
+                    board.step(action);
+                }
+
+                for (int seat = 0; seat < PLAYER_COUNT; ++seat) {
+                    scores[entry(seat)] = board.players[seat].score;
+                    ++stats.entries[entry(seat)].rounds;
+                }
+                if (board.winner != -1) {
+                    EntryStats& winner = stats.entries[entry(board.winner)];
+                    ++winner.wins;
+                    winner.tsumoWins += board.loser == -1;
+                    if (board.loser != -1) ++stats.entries[entry(board.loser)].dealIns;
+                }
+
+                if (!writer) continue;
+                RoundRecord& row = rows.emplace_back();
+                row.game = game;
+                row.round = round;
+                row.dealer = entry(board.dealer);
+                row.winner = board.winner == -1 ? -1 : entry(board.winner);
+                row.loser = board.loser == -1 ? -1 : entry(board.loser);
+                row.han = board.winScore.han;
+                row.fu = board.winScore.fu;
+                row.yakuMask = board.winScore.yakuMask;
+                std::copy(scores, scores + PLAYER_COUNT, row.scores);
+                if (rows.size() >= TOURNAMENT_CHUNK) writer->submit(rows);
+            }
+
+            // placements by final score, ties go to the entry that started in the earlier seat
+            int8_t order[PLAYER_COUNT];
+            for (int i = 0; i < PLAYER_COUNT; ++i)
+                order[i] = (game + i) % PLAYER_COUNT; // entry in starting seat i
+            std::stable_sort(order, order + PLAYER_COUNT, [&](int8_t a, int8_t b) { return scores[a] > scores[b]; });
+            for (int rank = 0; rank < PLAYER_COUNT; ++rank) {
+                EntryStats& entryStats = stats.entries[order[rank]];
+                ++entryStats.games;
+                ++entryStats.ranks[rank];
+                entryStats.rankSum += rank + 1;
+                entryStats.rankSquareSum += (rank + 1) * (rank + 1);
+                entryStats.scoreSum += scores[order[rank]];
+                entryStats.scoreSquareSum += (double)scores[order[rank]] * scores[order[rank]];
+            }
+        }
+    }
+    if (writer && !rows.empty()) writer->submit(rows);
+}
+
+void Tournament::run(size_t games, int rounds, uint64_t seed, RoundWriter* writer) {
+    nextGame = 0;
+    workerStats.assign(workerCount, TournamentStats());
+    std::vector<std::thread> workers;
+    for (int w = 1; w < workerCount; ++w)
+        workers.emplace_back(&Tournament::work, this, w, games, rounds, seed, writer);
+    work(0, games, rounds, seed, writer);
+    for (std::thread& worker : workers) worker.join();
+
+    // per worker totals are only read once every worker has joined, so merging needs no locks
+    totals = TournamentStats();
+    for (const TournamentStats& stats : workerStats)
+        totals += stats;
+}
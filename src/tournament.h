@@ -0,0 +1,113 @@
+#pragma once
+
+#include "board.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* round results file
+    columnar (any path not ending in .csv): TournamentFileHeader, then blocks of rows
+        each block is a uint32_t row count followed by one array per column in RoundRecord member order
+        (scores are PLAYER_COUNT arrays, one per entry), so a column can be read without touching the others
+    csv (path ending in .csv): header line, then one line per round
+    rows are written in completion order (not game order) when running on several workers
+*/
+
+const char TOURNAMENT_MAGIC[4] = {'T', 'R', 'N', 'Y'};
+const uint32_t TOURNAMENT_VERSION = 1; // bump when the file layout changes
+const size_t TOURNAMENT_CHUNK = 4096; // rows a worker buffers before handing them to the writer
+
+// tournament policy, returns an index into actions (called concurrently from every worker, keep state thread local)
+typedef std::function<int(const Board& board, int8_t player, const ActionList& actions)> Policy;
+
+// one finished round, players are tournament entries (index into the policies), -1 if none
+struct RoundRecord {
+    uint64_t game;
+    uint8_t round; // round within the game
+    int8_t dealer; // entry seated as dealer
+    int8_t winner; // entry who won the round
+    int8_t loser; // entry who dealt in (ron only)
+    int16_t han; // han of the winning hand (0 on exhaustive draw)
+    int16_t fu; // fu of the winning hand
+    uint64_t yakuMask; // yaku of the winning hand
+    int32_t scores[PLAYER_COUNT]; // entry scores after the round
+};
+
+struct TournamentFileHeader {
+    char magic[4]; // TOURNAMENT_MAGIC
+    uint32_t version; // TOURNAMENT_VERSION
+    uint32_t playerCount; // PLAYER_COUNT (number of score columns)
+    uint32_t reserved;
+};
+
+// per entry totals, every worker keeps its own copy and they are added once the workers are done
+struct EntryStats {
+    uint64_t games = 0;
+    uint64_t rounds = 0;
+    uint64_t wins = 0;
+    uint64_t tsumoWins = 0;
+    uint64_t dealIns = 0;
+    uint64_t ranks[PLAYER_COUNT] = {}; // final placements (ties go to the earlier starting seat)
+    double scoreSum = 0; // final scores
+    double scoreSquareSum = 0;
+    double rankSum = 0; // placements from 1
+    double rankSquareSum = 0;
+    EntryStats& operator+=(const EntryStats& other);
+};
+
+struct alignas(64) TournamentStats { // aligned so workers never share a cache line
+    EntryStats entries[PLAYER_COUNT];
+    TournamentStats& operator+=(const TournamentStats& other);
+};
+
+// background writer, workers hand over full chunks of rows and the writer thread encodes and writes them
+// at most maxQueued chunks wait to be written, workers block beyond that so memory stays bounded
+class RoundWriter {
+    FILE* file = nullptr;
+    bool csv = false;
+    size_t maxQueued;
+    std::mutex mutex;
+    std::condition_variable wake; // writer waits for chunks
+    std::condition_variable space; // workers wait for queue space
+    std::vector<std::vector<RoundRecord>> queued;
+    std::vector<std::vector<RoundRecord>> spare; // written chunks, reused by workers
+    bool closing = false;
+    std::thread thread;
+    std::vector<uint8_t> block; // encoded columns
+
+    void work(); // writer loop
+    void write(const std::vector<RoundRecord>& rows); // encodes and writes one chunk
+public:
+    RoundWriter(size_t maxQueued = 64) : maxQueued(maxQueued) {}
+    ~RoundWriter() { close(); }
+    RoundWriter(const RoundWriter&) = delete;
+    RoundWriter& operator=(const RoundWriter&) = delete;
+    bool open(const std::string& path); // creates file and starts the writer thread, returns false if it cannot be created
+    void close(); // writes every queued chunk and closes file
+    void submit(std::vector<RoundRecord>& rows); // queues rows (left empty, with a recycled buffer when one is free)
+};
+
+// plays seeded games between PLAYER_COUNT entries on every worker thread
+// game g seats entry (g + i) % PLAYER_COUNT in seat i and the board moves the deal one seat per round, so every entry deals equally often
+// the walls of game g only depend on seed and g / PLAYER_COUNT, so each deal is played once from every seat and can be replayed with other policies
+class Tournament {
+    std::vector<Policy> policies;
+    int workerCount;
+    std::vector<TournamentStats> workerStats;
+    TournamentStats totals;
+
+    void work(int worker, size_t games, int rounds, uint64_t seed, RoundWriter* writer); // worker loop
+public:
+    std::atomic<size_t> nextGame = 0; // first game not yet taken by a worker (progress)
+
+    Tournament(std::vector<Policy> policies, int workerCount) : policies(std::move(policies)), workerCount(workerCount) {} // one policy per entry (PLAYER_COUNT, may repeat)
+    void run(size_t games, int rounds, uint64_t seed, RoundWriter* writer = nullptr); // plays games of rounds each, returns once all are done
+    inline const TournamentStats& stats() const { return totals; } // merged totals of the last run
+};
+
+uint64_t gameSeed(uint64_t seed, uint64_t game); // wall seed of a game (splitmix64 of the pair)
@@ -1,5 +1,8 @@
 #include "view.h"
 #include "board.h"
+#include "engine_stats.h"
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 
 inline void loadTexture(sf::Texture& texture, std::string path) {
@@ -19,6 +22,11 @@ int tile_spritesheet_index[1 << 7] = {};
 const uint8_t OPEN_TILE_TEX = 0b1111111;
 const uint8_t CLOSED_TILE_TEX = 0b1111110;
 
+// 3x5 pixel glyphs for the overlay (no font is shipped), rows top to bottom with the left pixel as the high bit
+const float GLYPH_PIXEL = 2.f; // screen pixels per glyph pixel
+const float STATS_MARGIN = 8.f;
+uint16_t glyphs[1 << 7] = {};
+
 inline void setMahjongSpriteTexture(TileType tileType) {
     sf::IntRect rect;
     rect.width = TILE_PIXEL_WIDTH;
@@ -39,6 +47,27 @@ void View::init() {
     };
     for (int i = 0; i < TILE_SHEET_SIZE; ++i)
         tile_spritesheet_index[tile_sheet_order[i]] = i;
+
+    const struct { char c; uint8_t rows[5]; } glyphRows[] = {
+        {'0', {7,5,5,5,7}}, {'1', {2,6,2,2,7}}, {'2', {7,1,7,4,7}}, {'3', {7,1,7,1,7}}, {'4', {5,5,7,1,1}},
+        {'5', {7,4,7,1,7}}, {'6', {7,4,7,5,7}}, {'7', {7,1,1,1,1}}, {'8', {7,5,7,5,7}}, {'9', {7,5,7,1,7}},
+        {'.', {0,0,0,0,2}}, {'/', {1,1,2,4,4}}, {'-', {0,0,7,0,0}},
+        {'A', {7,5,7,5,5}}, {'C', {7,4,4,4,7}}, {'D', {6,5,5,5,6}}, {'E', {7,4,6,4,7}}, {'F', {7,4,6,4,4}},
+        {'G', {7,4,5,5,7}}, {'I', {7,2,2,2,7}}, {'L', {4,4,4,4,7}}, {'M', {5,7,7,5,5}}, {'N', {6,5,5,5,5}},
+        {'O', {7,5,5,5,7}}, {'P', {7,5,7,4,4}}, {'R', {6,5,6,5,5}}, {'S', {7,4,7,1,7}}, {'T', {7,2,2,2,2}},
+        {'U', {5,5,5,5,7}}, {'W', {5,5,7,7,5}},
+    };
+    for (const auto& glyph : glyphRows)
+        for (int row = 0; row < 5; ++row)
+            glyphs[(size_t)glyph.c] |= glyph.rows[row] << (3 * (4 - row));
+}
+
+void View::setShowStats(bool show) {
+    showStats = show;
+    engineStats.enabled.store(show, std::memory_order_relaxed);
+    sampledSteps = engineStats.steps.load(std::memory_order_relaxed);
+    sampledScoringCalls = engineStats.scoringCalls.load(std::memory_order_relaxed);
+    rateClock.restart();
 }
 
 void View::open(unsigned int width, unsigned int height, unsigned int fps) {
@@ -46,25 +75,85 @@ void View::open(unsigned int width, unsigned int height, unsigned int fps) {
     window.setFramerateLimit(fps);
 }
 
-void drawHand(sf::RenderTarget& canvas, const Hand& hand) {
+void View::drawItem(const sf::Drawable& drawable) {
+    window.draw(drawable);
+    ++frameDraws;
+}
+
+void View::drawHand(const Hand& hand) {
     SortedHand sortedHand(hand);
     mahjongSprite.setScale({TILE_SCALE, TILE_SCALE});
-    float x = ((float)canvas.getSize().x - (float)sortedHand.size() * TILE_WIDTH) * 0.5f;
-    float y = (float)canvas.getSize().y * 0.85f;
+    float x = ((float)window.getSize().x - (float)sortedHand.size() * TILE_WIDTH) * 0.5f;
+    float y = (float)window.getSize().y * 0.85f;
     for (int i = 0; i < sortedHand.size(); ++i) {
         mahjongSprite.setPosition({x + TILE_WIDTH * (float)i, y});
         setMahjongSpriteTexture(OPEN_TILE_TEX);
-        canvas.draw(mahjongSprite);
+        drawItem(mahjongSprite);
         setMahjongSpriteTexture(sortedHand[i].type);
-        canvas.draw(mahjongSprite);
+        drawItem(mahjongSprite);
     }
 }
 
+// appends quads of a line of glyph text (unknown characters are blank)
+void appendText(sf::VertexArray& quads, const char* text, sf::Vector2f position, sf::Color color) {
+    for (; *text; ++text, position.x += 4 * GLYPH_PIXEL) {
+        uint16_t glyph = glyphs[(size_t)*text & 0x7f];
+        for (int bit = 0; bit < 15; ++bit) {
+            if (!((glyph >> (14 - bit)) & 1)) continue;
+            sf::Vector2f corner(position.x + (float)(bit % 3) * GLYPH_PIXEL, position.y + (float)(bit / 3) * GLYPH_PIXEL);
+            quads.append(sf::Vertex(corner, color));
+            quads.append(sf::Vertex({corner.x + GLYPH_PIXEL, corner.y}, color));
+            quads.append(sf::Vertex({corner.x + GLYPH_PIXEL, corner.y + GLYPH_PIXEL}, color));
+            quads.append(sf::Vertex({corner.x, corner.y + GLYPH_PIXEL}, color));
+        }
+    }
+}
+
+void View::drawStats() {
+    if (rateClock.getElapsedTime().asSeconds() >= 0.5f) {
+        float seconds = rateClock.restart().asSeconds();
+        uint64_t steps = engineStats.steps.load(std::memory_order_relaxed);
+        uint64_t scoringCalls = engineStats.scoringCalls.load(std::memory_order_relaxed);
+        stepsPerSecond = (float)(steps - sampledSteps) / seconds;
+        scoringPerSecond = (float)(scoringCalls - sampledScoringCalls) / seconds;
+        sampledSteps = steps;
+        sampledScoringCalls = scoringCalls;
+    }
+
+    char lines[7][32];
+    std::snprintf(lines[0], sizeof(lines[0]), "FRAME MS %.2f", frameMs);
+    std::snprintf(lines[1], sizeof(lines[1]), "DRAWS %u", drawCalls);
+    std::snprintf(lines[2], sizeof(lines[2]), "STEPS/S %.0f", stepsPerSecond);
+    std::snprintf(lines[3], sizeof(lines[3]), "SCORES/S %.0f", scoringPerSecond);
+    const char* stageNames[SCORING_STAGES] = {"SORT", "GROUPS", "SPECIAL"};
+    for (int stage = 0; stage < SCORING_STAGES; ++stage)
+        std::snprintf(lines[4 + stage], sizeof(lines[4 + stage]), "%s US %.2f", stageNames[stage], engineStats.stageNanos[stage].load(std::memory_order_relaxed) * 1e-3f);
+
+    // background and text are one draw call each
+    size_t columns = 0;
+    for (const char* line : lines)
+        columns = std::max(columns, std::strlen(line));
+    const float lineHeight = 7 * GLYPH_PIXEL;
+    sf::RectangleShape background({(float)columns * 4 * GLYPH_PIXEL + 2 * STATS_MARGIN, 7 * lineHeight + 2 * STATS_MARGIN});
+    background.setFillColor(sf::Color(0, 0, 0, 160));
+    drawItem(background);
+    sf::VertexArray quads(sf::Quads);
+    for (int i = 0; i < 7; ++i)
+        appendText(quads, lines[i], {STATS_MARGIN, STATS_MARGIN + (float)i * lineHeight}, sf::Color::White);
+    drawItem(quads);
+}
+
 void View::draw() {
+    frameMs = frameClock.restart().asSeconds() * 1e3f;
     window.clear(sf::Color(200,200,200));
+    frameDraws = 0;
 
     // draw hands
-    drawHand(window, board.players[0].hand);
+    drawHand(board.players[0].hand);
+
+    if (showStats) drawStats(); // shows the count of the last frame, the overlay is drawn before this one is complete
+
+    drawCalls = frameDraws;
 
     // display call
     window.display();
@@ -6,6 +6,7 @@
 struct View {
     Board& board;
     sf::RenderWindow window;
+    bool showStats = false; // performance overlay (frame time, draw calls, engine rates and scoring stage timings)
 
     View(Board& board) : board(board) {}
 
@@ -14,4 +15,21 @@ struct View {
     void open(unsigned int width, unsigned int height, unsigned int fps); // opens display window
 
     void draw(); // draws window
-};
\ No newline at end of file
+
+    void setShowStats(bool show); // shows or hides the overlay (engine stats are only collected while shown)
+private:
+    // overlay state, rates are resampled a few times a second so they stay readable
+    sf::Clock frameClock; // time since last frame
+    sf::Clock rateClock; // time since rates were last sampled
+    float frameMs = 0;
+    unsigned int frameDraws = 0; // draw calls of the frame being drawn
+    unsigned int drawCalls = 0; // draw calls of the last frame (overlay included)
+    uint64_t sampledSteps = 0;
+    uint64_t sampledScoringCalls = 0;
+    float stepsPerSecond = 0;
+    float scoringPerSecond = 0;
+
+    void drawItem(const sf::Drawable& drawable); // draws to the window, every draw call goes through here so it is counted
+    void drawHand(const Hand& hand); // draws hand along the bottom
+    void drawStats(); // draws the overlay in the top left corner
+};
@@ -0,0 +1,349 @@
+// engine rule checks run by ctest, a failed check prints its line and the test exits non zero
+#include "board.h"
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <random>
+
+int failures = 0;
+#define CHECK(condition) do { if (!(condition)) { std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); ++failures; } } while (0)
+
+// replaces a player's hand, melds are called (open) 3 tiles at a time, then closed tiles and the drawn tile (NONE for a 13 tile hand)
+void setHand(Player& player, std::initializer_list<Tile> melds, std::initializer_list<Tile> closed, TileType drawn = NONE) {
+    Hand& hand = player.hand = Hand();
+    const Tile* meld = melds.begin();
+    for (; meld != melds.end(); meld += 3) {
+        for (int k = 0; k < 3; ++k)
+            hand.setTile(hand.callTiles + k, meld[k]);
+        hand.call(0b111u << hand.callTiles, Tile(), true);
+    }
+    int i = hand.callTiles;
+    for (Tile tile : closed)
+        hand.setTile(i++, tile);
+    if (drawn != NONE) hand.setTile(DRAWN_I, Tile(drawn));
+}
+
+// first legal action of a type (nullptr if none)
+const Action* findAction(const ActionList& actions, Action::Type type) {
+    for (int i = 0; i < actions.size(); ++i)
+        if (actions[i].type == type) return &actions[i];
+    return nullptr;
+}
+
+// has player discard its drawn tile on its turn
+void discardDrawn(Board& board, int8_t playerIndex) {
+    board.phase = Board::TurnPhase;
+    board.currentPlayer = playerIndex;
+    board.step(Action(Action::Discard, playerIndex, DRAWN_I));
+}
+
+// tiles held by a player (call tiles included)
+int handSize(const Player& player) {
+    int size = player.hand.callTiles;
+    for (int i = 0; i < TILE_TYPES; ++i) size += player.hand.counts[i];
+    return size;
+}
+
+// kans take the red five along with the other copies
+void testRedFiveKans() {
+    ActionList actions;
+    {
+        Board board;
+        int8_t p = board.currentPlayer;
+        setHand(board.players[p], {}, {PIN5, PIN5, Tile(PIN5, true), SOU1, SOU2, SOU3, MAN2, MAN3, MAN4, SOU6, SOU7, SOU8, WNDN}, PIN5);
+        board.legalActions(p, actions);
+        const Action* kan = findAction(actions, Action::ClosedKan);
+        CHECK(kan && std::popcount(kan->handMask) == 4);
+        if (kan) board.step(*kan);
+        CHECK(board.players[p].hand.callTiles == 4);
+        CHECK(handSize(board.players[p]) == 15); // kan, 10 closed tiles and the rinshan draw
+    }
+    {
+        Board board;
+        setHand(board.players[1], {}, {PIN5, PIN5, Tile(PIN5, true), SOU1, SOU2, SOU3, MAN2, MAN3, MAN4, SOU6, SOU7, SOU8, WNDN});
+        setHand(board.players[0], {}, {WNDE, WNDE, WNDE, WNDS, WNDS, WNDS, WNDW, WNDW, WNDW, DGNW, DGNW, DGNG, DGNG}, PIN5);
+        discardDrawn(board, 0);
+        board.legalActions(1, actions);
+        const Action* kan = findAction(actions, Action::Kan);
+        CHECK(kan && std::popcount(kan->handMask) == 3);
+        if (kan) board.step(*kan);
+        CHECK(board.players[1].hand.callTiles == 4);
+        CHECK(handSize(board.players[1]) == 15);
+    }
+}
+
+// counts and call masks kept up to date by every action match a recount of the tiles
+void testIncrementalMasks() {
+    std::mt19937 random(1);
+    ActionList actions;
+    Board board;
+    for (int round = 0; round < 200; ++round) {
+        if (round) board.nextRound();
+        while (board.phase != Board::EndPhase) {
+            // first player in turn order with a decision picks a random action
+            for (int i = 0; i < PLAYER_COUNT; ++i) {
+                board.legalActions((board.currentPlayer + i) % PLAYER_COUNT, actions);
+                if (actions.size()) break;
+            }
+            if (!actions.size()) break;
+            board.step(actions[random() % actions.size()]);
+            for (const Player& player : board.players) {
+                Hand recounted = player.hand;
+                recounted.recount();
+                bool same = !std::memcmp(recounted.counts, player.hand.counts, sizeof(recounted.counts)) && recounted.heldMask == player.hand.heldMask
+                    && recounted.ponMask == player.hand.ponMask && recounted.kanMask == player.hand.kanMask && recounted.chiMask == player.hand.chiMask;
+                CHECK(same);
+                if (!same) return;
+            }
+        }
+    }
+}
+
+// tiles every player can see, from the rivers, call tiles taken from the hand (claimed tiles count in the river) and dora indicators
+void countVisible(const Board& board, uint8_t visible[TILE_TYPES]) {
+    std::memset(visible, 0, TILE_TYPES);
+    for (const Player& player : board.players) {
+        for (int i = 0; i < player.discardCount; ++i)
+            ++visible[TYPE_INDEX_MAP[*player.discards[i]]];
+        for (int i = 0; i < player.hand.callTiles; ++i) {
+            Tile::Action action = player.hand.tiles[i].getLastAction();
+            if (action != Tile::Action::Discard && action != Tile::Action::Tsumogiri) ++visible[TYPE_INDEX_MAP[player.hand[i]]];
+        }
+    }
+    for (int i = 0; i < board.revealedDora; ++i)
+        ++visible[TYPE_INDEX_MAP[*board.wall[DORA_OFFSET + (i << 1)]]];
+}
+
+// visible and unseen counts and danger tables updated on every reveal match a count and danger computed from scratch
+void testTileVisibility() {
+    std::mt19937 random(2);
+    ActionList actions;
+    Board board;
+    for (int round = 0; round < 100; ++round) {
+        if (round) board.nextRound();
+        while (board.phase != Board::EndPhase) {
+            for (int i = 0; i < PLAYER_COUNT; ++i) {
+                board.legalActions((board.currentPlayer + i) % PLAYER_COUNT, actions);
+                if (actions.size()) break;
+            }
+            if (!actions.size()) break;
+            board.step(actions[random() % actions.size()]);
+            uint8_t visible[TILE_TYPES];
+            countVisible(board, visible);
+            bool same = !std::memcmp(visible, board.visibleCounts, sizeof(visible));
+            for (int p = 0; p < PLAYER_COUNT; ++p)
+                for (int t = 0; t < TILE_TYPES; ++t)
+                    same &= board.players[p].danger[t] == board.tileDanger(p, t);
+
+            // a player sees the visible tiles and its own closed tiles (a ron winning tile is in the hand and the river)
+            for (int p = 0; p < PLAYER_COUNT && board.phase != Board::EndPhase; ++p)
+                for (int t = 0; t < TILE_TYPES; ++t)
+                    same &= board.unseenCounts[p][t] == 4 - visible[t] - board.players[p].hand.counts[t];
+            CHECK(same);
+            if (!same) return;
+        }
+    }
+}
+
+bool hasAction(const ActionList& actions, Action::Type type) {
+    return findAction(actions, type) != nullptr;
+}
+
+// a complete hand without a yaku cannot win, neither by tsumo nor by ron
+void testYakulessWin() {
+    ActionList actions;
+    {
+        Board board;
+        int8_t p = board.currentPlayer;
+        setHand(board.players[p], {PIN1, PIN2, PIN3}, {SOU4, SOU5, SOU6, MAN2, MAN3, MAN4, SOU6, SOU7, SOU8, PIN9}, PIN9);
+        board.legalActions(p, actions);
+        CHECK(!hasAction(actions, Action::Tsumo));
+
+        // closed, the same tiles win on menzen tsumo
+        setHand(board.players[p], {}, {PIN1, PIN2, PIN3, SOU4, SOU5, SOU6, MAN2, MAN3, MAN4, SOU6, SOU7, SOU8, PIN9}, PIN9);
+        board.legalActions(p, actions);
+        CHECK(hasAction(actions, Action::Tsumo));
+    }
+    {
+        Board board;
+        setHand(board.players[1], {PIN1, PIN2, PIN3}, {SOU4, SOU5, SOU6, MAN2, MAN3, MAN4, SOU6, SOU7, SOU8, PIN9}, WNDN);
+        discardDrawn(board, 1);
+        CHECK(board.players[1].hand.ronMask == 1ull << TYPE_INDEX_MAP[PIN9]);
+        setHand(board.players[2], {}, {WNDE, WNDE, WNDE, WNDS, WNDS, WNDS, WNDW, WNDW, WNDW, DGNW, DGNW, DGNG, DGNG}, PIN9);
+        discardDrawn(board, 2);
+        CHECK(board.players[1].ronYakuScored && board.players[1].ronYakuMask == 0);
+        board.legalActions(1, actions);
+        CHECK(!hasAction(actions, Action::Ron));
+        CHECK(board.players[1].tempFuriten); // passing the winning tile is still furiten
+    }
+    {
+        // open all simples has a yaku
+        Board board;
+        setHand(board.players[1], {PIN2, PIN3, PIN4}, {SOU4, SOU5, SOU6, MAN2, MAN3, MAN4, SOU6, SOU7, SOU8, PIN8}, WNDN);
+        discardDrawn(board, 1);
+        setHand(board.players[2], {}, {WNDE, WNDE, WNDE, WNDS, WNDS, WNDS, WNDW, WNDW, WNDW, DGNW, DGNW, DGNG, DGNG}, PIN8);
+        discardDrawn(board, 2);
+        CHECK(board.players[1].ronYakuMask == 1ull << TYPE_INDEX_MAP[PIN8]);
+        board.legalActions(1, actions);
+        CHECK(hasAction(actions, Action::Ron));
+    }
+}
+
+// value of the current player's winning hand on its turn
+template <typename Rules = StandardRules>
+ScoreInfo tsumoValue(std::initializer_list<Tile> melds, std::initializer_list<Tile> closed, TileType drawn) {
+    BasicBoard<Rules> board;
+    int8_t p = board.currentPlayer;
+    setHand(board.players[p], melds, closed, drawn);
+    return board.valueOfHand(p);
+}
+
+// edge, middle and single waits add 2 fu, a sides wait keeps pinfu
+void testWaitFu() {
+    ScoreInfo middle = tsumoValue({}, {PIN3, PIN5, SOU2, SOU3, SOU4, MAN2, MAN3, MAN4, MAN5, MAN6, MAN7, SOU8, SOU8}, PIN4);
+    CHECK(middle.fu == 30);
+    CHECK(!middle.hasYaku(Pinfu));
+    ScoreInfo sides = tsumoValue({}, {PIN3, PIN4, SOU2, SOU3, SOU4, MAN2, MAN3, MAN4, MAN5, MAN6, MAN7, SOU8, SOU8}, PIN5);
+    CHECK(sides.fu == 20);
+    CHECK(sides.hasYaku(Pinfu));
+    ScoreInfo edge = tsumoValue({}, {PIN1, PIN2, SOU1, SOU2, SOU3, MAN7, MAN8, MAN9, SOU7, SOU8, SOU9, MAN1, MAN1}, PIN3);
+    CHECK(edge.fu == 30);
+    CHECK(!edge.hasYaku(Pinfu));
+
+    // every wait of a 13 tile hand is scored the same way
+    Board board;
+    setHand(board.players[1], {}, {PIN3, PIN5, SOU2, SOU3, SOU4, MAN2, MAN3, MAN4, MAN5, MAN6, MAN7, SOU8, SOU8});
+    WaitScores scores;
+    board.valueOfWaits(1, scores);
+    CHECK(scores.size() == 1 && scores[0].tsumo.fu == 30);
+}
+
+// each dragon type is counted on its own
+void testThreeDragons() {
+    ScoreInfo big = tsumoValue({}, {DGNW, DGNW, DGNW, DGNG, DGNG, DGNG, DGNR, DGNR, DGNR, PIN1, PIN2, PIN3, PIN5}, PIN5);
+    CHECK(big.hasYaku(BigThreeDragons));
+    ScoreInfo little = tsumoValue({}, {DGNW, DGNW, DGNW, DGNG, DGNG, DGNG, DGNR, DGNR, PIN1, PIN2, PIN3, PIN5, PIN5}, PIN5);
+    CHECK(little.hasYaku(LittleThreeDragons));
+    ScoreInfo open = tsumoValue({DGNW, DGNW, DGNW}, {DGNG, DGNG, DGNG, DGNR, DGNR, DGNR, PIN1, PIN2, PIN3, PIN5}, PIN5);
+    CHECK(open.hasYaku(BigThreeDragons));
+}
+
+// tile yaku count call tiles too
+void testCallTileYaku() {
+    ScoreInfo honors = tsumoValue({MAN2, MAN3, MAN4}, {WNDE, WNDE, WNDE, WNDS, WNDS, WNDS, DGNR, DGNR, DGNR, WNDN}, WNDN);
+    CHECK(!honors.hasYaku(AllHonors));
+    CHECK(!honors.hasYaku(CommonTerminals));
+    ScoreInfo terminals = tsumoValue({PIN2, PIN3, PIN4}, {PIN1, PIN1, PIN1, SOU9, SOU9, SOU9, MAN1, MAN1, MAN1, WNDN}, WNDN);
+    CHECK(!terminals.hasYaku(CommonTerminals));
+}
+
+// kuitan and double yakuman follow the rule set
+void testRuleSets() {
+    auto openSimples = [](auto value) {
+        return value({PIN2, PIN3, PIN4}, {SOU4, SOU5, SOU6, MAN2, MAN3, MAN4, SOU6, SOU7, SOU8, PIN8}, PIN8);
+    };
+    CHECK(openSimples(tsumoValue<StandardRules>).hasYaku(AllSimples));
+    CHECK(openSimples(tsumoValue<ClassicRules>).han == 0);
+
+    auto fourWinds = [](auto value) {
+        return value({}, {WNDE, WNDE, WNDE, WNDS, WNDS, WNDS, WNDW, WNDW, WNDW, WNDN, WNDN, WNDN, PIN5}, PIN5);
+    };
+    CHECK(fourWinds(tsumoValue<StandardRules>).yakuHan[BigFourWinds] == DOUBLE_YAKUMAN_HAN);
+    CHECK(fourWinds(tsumoValue<SanmaRules>).yakuHan[BigFourWinds] == DOUBLE_YAKUMAN_HAN);
+    CHECK(fourWinds(tsumoValue<ClassicRules>).yakuHan[BigFourWinds] == YAKUMAN_HAN);
+    CHECK(fourWinds(tsumoValue<ClassicRules>).basicPoints() == 8000);
+}
+
+// honor sets count open or closed, a wind once per matching wind (east round, the dealer sits east)
+void testHonorTiles() {
+    ScoreInfo closedDragon = tsumoValue({}, {DGNW, DGNW, DGNW, PIN2, PIN3, PIN4, SOU4, SOU5, SOU6, MAN2, MAN3, MAN4, PIN8}, PIN8);
+    CHECK(closedDragon.yakuHan[HonorTiles] == 1);
+    ScoreInfo openDragon = tsumoValue({DGNR, DGNR, DGNR}, {PIN2, PIN3, PIN4, SOU4, SOU5, SOU6, MAN2, MAN3, MAN4, PIN8}, PIN8);
+    CHECK(openDragon.yakuHan[HonorTiles] == 1);
+    CHECK(openDragon.han == 1);
+    ScoreInfo doubleWind = tsumoValue({WNDE, WNDE, WNDE}, {PIN2, PIN3, PIN4, SOU4, SOU5, SOU6, MAN2, MAN3, MAN4, PIN8}, PIN8);
+    CHECK(doubleWind.yakuHan[HonorTiles] == 2);
+    ScoreInfo otherWind = tsumoValue({WNDW, WNDW, WNDW}, {PIN2, PIN3, PIN4, SOU4, SOU5, SOU6, MAN2, MAN3, MAN4, PIN8}, PIN8);
+    CHECK(otherWind.han == 0);
+
+    // south is the seat wind of the next player only
+    Board board;
+    board.currentPlayer = 1;
+    setHand(board.players[1], {WNDS, WNDS, WNDS}, {PIN2, PIN3, PIN4, SOU4, SOU5, SOU6, MAN2, MAN3, MAN4, PIN8}, PIN8);
+    CHECK(board.valueOfHand(1).yakuHan[HonorTiles] == 1);
+}
+
+// payments follow the dealer as the deal moves, and karaten is noten on an exhaustive draw
+void testSettlement() {
+    auto payment = [](int basicPoints, int multiplier) { return (basicPoints * multiplier + 99) / 100 * 100; };
+    {
+        // dealer (player 1) wins by tsumo, every other player pays double
+        Board board;
+        board.nextRound();
+        CHECK(board.dealer == 1);
+        CHECK(board.currentPlayer == 1);
+        CHECK(board.players[1].seatWind == 0);
+        CHECK(board.players[0].seatWind == PLAYER_COUNT - 1);
+        setHand(board.players[1], {}, {PIN2, PIN3, PIN4, SOU4, SOU5, SOU6, MAN2, MAN3, MAN4, SOU6, SOU7, SOU8, PIN8}, PIN8);
+        board.step(Action(Action::Tsumo, 1));
+        int paid = payment(board.winScore.basicPoints(), 2);
+        CHECK(board.winner == 1);
+        CHECK(board.players[1].score == 25000 + 3 * paid);
+        CHECK(board.players[0].score == 25000 - paid);
+        CHECK(board.players[3].score == 25000 - paid);
+    }
+    {
+        // player 0 wins by tsumo while player 1 deals, only the dealer pays double
+        Board board;
+        board.nextRound();
+        board.currentPlayer = 0;
+        setHand(board.players[0], {}, {PIN2, PIN3, PIN4, SOU4, SOU5, SOU6, MAN2, MAN3, MAN4, SOU6, SOU7, SOU8, PIN8}, PIN8);
+        board.step(Action(Action::Tsumo, 0));
+        int basicPoints = board.winScore.basicPoints();
+        CHECK(board.players[1].score == 25000 - payment(basicPoints, 2));
+        CHECK(board.players[2].score == 25000 - payment(basicPoints, 1));
+        CHECK(board.players[0].score == 25000 + payment(basicPoints, 2) + 2 * payment(basicPoints, 1));
+    }
+    {
+        // exhaustive draw: player 1 is tenpai, player 2 only waits on a tile it holds every copy of (closed pin 5 kan, waiting on pin 5)
+        Board board;
+        setHand(board.players[1], {}, {SOU4, SOU5, SOU6, MAN2, MAN3, MAN4, SOU6, SOU7, SOU8, PIN2, PIN3, PIN4, PIN9});
+        Hand& karaten = board.players[2].hand = Hand();
+        for (int k = 0; k < 4; ++k)
+            karaten.setTile(k, Tile(PIN5));
+        karaten.call(0b1111u, Tile(), false);
+        int i = karaten.callTiles;
+        for (TileType tileType : {PIN4, PIN6, SOU4, SOU5, SOU6, SOU6, SOU7, SOU8, MAN2, MAN2})
+            karaten.setTile(i++, Tile(tileType));
+        setHand(board.players[3], {}, {WNDE, WNDS, WNDW, DGNW, DGNG, DGNR, PIN1, PIN5, PIN9, SOU1, SOU5, SOU9, MAN1});
+        setHand(board.players[0], {}, {WNDE, WNDS, WNDW, DGNW, DGNG, DGNR, PIN1, PIN5, PIN8, SOU1, SOU5, SOU9, MAN1}, MAN5);
+        for (int p = 1; p < PLAYER_COUNT; ++p)
+            board.players[p].hand.updateWaits();
+        CHECK(board.players[2].hand.ronMask == 1ull << TYPE_INDEX_MAP[PIN5]);
+        CHECK(board.tenpai(1));
+        CHECK(!board.tenpai(2));
+        board.drawIndex = DEAD_WALL_SIZE + board.kanCount - 1; // live wall empty
+        discardDrawn(board, 0);
+        CHECK(board.phase == Board::EndPhase);
+        CHECK(board.winner == -1);
+        CHECK(board.players[1].score == 25000 + 3000);
+        CHECK(board.players[2].score == 25000 - 1000);
+        CHECK(board.players[0].score == 25000 - 1000);
+    }
+}
+
+int main() {
+    testRedFiveKans();
+    testIncrementalMasks();
+    testTileVisibility();
+    testWaitFu();
+    testYakulessWin();
+    testThreeDragons();
+    testCallTileYaku();
+    testRuleSets();
+    testHonorTiles();
+    testSettlement();
+    if (failures) std::printf("%d checks failed\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,60 @@
+// scores a generated hand corpus by search and again through the agari table, both must agree on every hand's value
+// (readings of equal value may differ in han and fu, each path keeps the first best one it finds)
+// usage: corpus_test <corpus path> <agari table path>
+#include "agari.h"
+#include "corpus.h"
+#include <cstdio>
+#include <vector>
+
+// scores every corpus hand with whichever decomposition path is active (the board's dora stay the same between calls)
+void scoreCorpus(Board& board, const HandCorpus& corpus, std::vector<ScoreInfo>& scores) {
+    Player& player = board.players[0];
+    WaitScores waitScores;
+    scores.clear();
+    for (size_t i = 0; i < corpus.size(); ++i) {
+        const CorpusRecord& record = corpus[i];
+        loadHand(record, player.hand);
+        player.ronActive = record.flags & CORPUS_RON;
+        if (record.kind == CorpusTenpai) {
+            board.valueOfWaits(0, waitScores);
+            for (int w = 0; w < waitScores.size(); ++w) {
+                scores.push_back(waitScores[w].ron);
+                scores.push_back(waitScores[w].tsumo);
+            }
+        } else {
+            scores.push_back(board.valueOfHand(0));
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::printf("usage: corpus_test <corpus path> <agari table path>\n");
+        return 1;
+    }
+    HandCorpus corpus;
+    if (!corpus.open(argv[1]) || !corpus.size()) {
+        std::printf("cannot open corpus %s\n", argv[1]);
+        return 1;
+    }
+    Board board;
+    std::vector<ScoreInfo> searched, looked;
+    scoreCorpus(board, corpus, searched);
+    if (!AgariTable::load(argv[2])) {
+        std::printf("cannot load agari table %s\n", argv[2]);
+        return 1;
+    }
+    scoreCorpus(board, corpus, looked);
+
+    if (searched.size() != looked.size()) {
+        std::printf("search gave %zu scores, the table %zu\n", searched.size(), looked.size());
+        return 1;
+    }
+    size_t mismatches = 0;
+    for (size_t i = 0; i < searched.size(); ++i)
+        mismatches += searched[i].basicPoints() != looked[i].basicPoints() || (searched[i].han > 0) != (looked[i].han > 0);
+    int winning = 0;
+    for (const ScoreInfo& score : searched) winning += score.han > 0;
+    std::printf("%zu hands, %zu scores (%d with a yaku), %zu mismatches\n", corpus.size(), searched.size(), winning, mismatches);
+    return mismatches != 0 || !winning;
+}
@@ -0,0 +1,186 @@
+// offline generator for the agari table (see src/agari.h for the file layout)
+// usage: agari_gen <output path>
+#include "agari.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+typedef std::array<uint8_t, TILE_TYPES> Counts;
+
+// closed group of a decomposition (type index of first tile)
+struct ShapeGroup {
+    int8_t typeIndex;
+    bool run;
+    bool operator<(const ShapeGroup& other) const {
+        return typeIndex != other.typeIndex ? typeIndex < other.typeIndex : run < other.run;
+    }
+};
+
+// whether a run can start at type index
+inline bool runStart(int typeIndex) {
+    return typeIndex >= 7 && (typeIndex - 7) % 9 <= 6;
+}
+
+// enumerates every complete shape with groupsLeft more groups and one pair (one representative counts per key)
+void enumerateShapes(std::unordered_map<uint64_t, Counts>& shapes, Counts& counts, int nextGroup, int groupsLeft) {
+    if (groupsLeft == 0) {
+        for (int t = 0; t < TILE_TYPES; ++t) {
+            if (counts[t] > 2) continue;
+            counts[t] += 2;
+            shapes.emplace(AgariShape(counts.data()).key, counts);
+            counts[t] -= 2;
+        }
+        return;
+    }
+
+    // groups 0-33 are triplets, 34-54 are runs (non-decreasing order avoids permutations)
+    for (int g = nextGroup; g < TILE_TYPES + 21; ++g) {
+        if (g < TILE_TYPES) {
+            if (counts[g] > 1) continue;
+            counts[g] += 3;
+            enumerateShapes(shapes, counts, g, groupsLeft - 1);
+            counts[g] -= 3;
+        } else {
+            int t = 7 + (g - TILE_TYPES) / 7 * 9 + (g - TILE_TYPES) % 7;
+            if (counts[t] == 4 || counts[t+1] == 4 || counts[t+2] == 4) continue;
+            ++counts[t]; ++counts[t+1]; ++counts[t+2];
+            enumerateShapes(shapes, counts, g, groupsLeft - 1);
+            --counts[t]; --counts[t+1]; --counts[t+2];
+        }
+    }
+}
+
+// finds all distinct decompositions (tiles of type t are split into at most one pair, at most one triplet and runs starting at t)
+void decompose(std::vector<std::pair<int8_t, std::vector<ShapeGroup>>>& results, Counts& counts, int t, int8_t pair, std::vector<ShapeGroup>& groups) {
+    while (t < TILE_TYPES && counts[t] == 0) ++t;
+    if (t == TILE_TYPES) {
+        if (pair != -1) results.emplace_back(pair, groups);
+        return;
+    }
+    for (int usePair = 0; usePair <= (pair == -1); ++usePair) {
+        for (int useTriplet = 0; useTriplet <= 1; ++useTriplet) {
+            int runs = counts[t] - usePair * 2 - useTriplet * 3;
+            if (runs < 0 || (runs && (!runStart(t) || counts[t+1] < runs || counts[t+2] < runs))) continue;
+            uint8_t taken = counts[t];
+            counts[t] = 0;
+            counts[t+1] -= runs;
+            counts[t+2] -= runs;
+            if (useTriplet) groups.push_back({(int8_t)t, false});
+            for (int r = 0; r < runs; ++r) groups.push_back({(int8_t)t, true});
+            decompose(results, counts, t + 1, usePair ? t : pair, groups);
+            groups.resize(groups.size() - useTriplet - runs);
+            counts[t] = taken;
+            counts[t+1] += runs;
+            counts[t+2] += runs;
+        }
+    }
+}
+
+// packs a decomposition into positions
+uint32_t encodeDecomposition(const AgariShape& shape, int8_t pair, std::vector<ShapeGroup> groups) {
+    int8_t typePositions[TILE_TYPES];
+    for (int p = 0; p < shape.positions; ++p) typePositions[shape.positionTypes[p]] = p;
+    std::sort(groups.begin(), groups.end());
+
+    uint32_t decomposition = typePositions[pair];
+    for (int g = 0; g < groups.size(); ++g) {
+        decomposition |= (uint32_t)groups[g].run << (4 + g * 5);
+        decomposition |= (uint32_t)typePositions[groups[g].typeIndex] << (5 + g * 5);
+    }
+    return decomposition;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "usage: agari_gen <output path>" << std::endl;
+        return 1;
+    }
+
+    // enumerate shapes
+    std::unordered_map<uint64_t, Counts> shapes;
+    Counts counts = {};
+    for (int groups = 0; groups <= MAX_GROUPS; ++groups)
+        enumerateShapes(shapes, counts, 0, groups);
+
+    // build records (ordered by key so output is reproducible)
+    std::map<uint64_t, AgariRecord> recordMap;
+    for (auto& [key, shapeCounts] : shapes) {
+        AgariShape shape(shapeCounts.data());
+        AgariRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.key = key;
+
+        std::vector<std::pair<int8_t, std::vector<ShapeGroup>>> results;
+        std::vector<ShapeGroup> groups;
+        Counts work = shapeCounts;
+        decompose(results, work, 0, -1, groups);
+        if (results.size() > MAX_AGARI_DECOMPOSITIONS) {
+            std::cerr << "shape " << key << " has " << results.size() << " decompositions" << std::endl;
+            return 1;
+        }
+        for (auto& [pair, shapeGroups] : results)
+            record.decompositions[record.decompositionCount++] = encodeDecomposition(shape, pair, shapeGroups);
+        recordMap[key] = record;
+    }
+    std::vector<AgariRecord> sortedRecords;
+    for (auto& [key, record] : recordMap) sortedRecords.push_back(record);
+
+    // minimal perfect hash (hash and displace): place largest buckets first, search a seed that fits each bucket
+    AgariHeader header;
+    header.magic = AGARI_MAGIC;
+    header.version = AGARI_VERSION;
+    header.recordCount = sortedRecords.size();
+    header.bucketCount = ((header.recordCount / 4) + 1) & ~1u; // even so records stay 8 byte aligned
+    std::vector<std::vector<uint32_t>> buckets(header.bucketCount);
+    for (uint32_t i = 0; i < sortedRecords.size(); ++i)
+        buckets[agariHash(sortedRecords[i].key, 0) % header.bucketCount].push_back(i);
+    std::vector<uint32_t> bucketOrder(header.bucketCount);
+    for (uint32_t b = 0; b < header.bucketCount; ++b) bucketOrder[b] = b;
+    std::stable_sort(bucketOrder.begin(), bucketOrder.end(), [&](uint32_t a, uint32_t b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    std::vector<uint32_t> seeds(header.bucketCount, 0);
+    std::vector<AgariRecord> table(header.recordCount);
+    std::vector<bool> used(header.recordCount, false);
+    for (uint32_t b : bucketOrder) {
+        if (buckets[b].empty()) continue;
+        std::vector<uint32_t> slots;
+        for (uint32_t seed = 1; ; ++seed) {
+            slots.clear();
+            for (uint32_t i : buckets[b]) {
+                uint32_t slot = agariHash(sortedRecords[i].key, seed) % header.recordCount;
+                if (used[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) break;
+                slots.push_back(slot);
+            }
+            if (slots.size() != buckets[b].size()) continue;
+            seeds[b] = seed;
+            for (int k = 0; k < slots.size(); ++k) {
+                used[slots[k]] = true;
+                table[slots[k]] = sortedRecords[buckets[b][k]];
+            }
+            break;
+        }
+    }
+
+    // write table
+    std::filesystem::path path(argv[1]);
+    if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path());
+    FILE* file = fopen(argv[1], "wb");
+    if (!file) {
+        std::cerr << "cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(seeds.data(), sizeof(uint32_t), seeds.size(), file);
+    fwrite(table.data(), sizeof(AgariRecord), table.size(), file);
+    fclose(file);
+    std::cout << "agari table: " << header.recordCount << " shapes, " << header.bucketCount << " buckets -> " << argv[1] << std::endl;
+    return 0;
+}
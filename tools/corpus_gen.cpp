@@ -0,0 +1,252 @@
+// offline generator for benchmark hand corpora (see src/corpus.h for the file layout)
+// usage: corpus_gen <output path> <hands per kind> [seed]
+// every hand is built directly from groups drawn out of a full 136 tile set, so no sample is rejected
+#include "corpus.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+// xorshift64* generator (fast and reproducible across platforms, unlike std distributions)
+struct Random {
+    uint64_t state;
+    Random(uint64_t seed) : state(seed ? seed : 0x9e3779b97f4a7c15ull) {}
+    inline uint64_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545f4914f6cdd1dull;
+    }
+    // uniform in [0, n)
+    inline uint32_t below(uint32_t n) {
+        return (uint32_t)(((next() >> 32) * n) >> 32);
+    }
+};
+
+// tiles left to draw by type index, tracking red fives separately so they keep their real odds
+struct TilePool {
+    uint8_t left[TILE_TYPES];
+    uint8_t redLeft[TILE_TYPES];
+
+    // takes one copy of a type (red with probability redLeft / left)
+    inline uint8_t take(Random& random, int typeIndex) {
+        bool red = random.below(left[typeIndex]) < redLeft[typeIndex];
+        --left[typeIndex];
+        redLeft[typeIndex] -= red;
+        return INDEX_TYPE_MAP[typeIndex] | red << 6;
+    }
+};
+
+// whether a run can start at type index
+inline bool runStart(int typeIndex) {
+    return typeIndex >= 7 && (typeIndex - 7) % 9 <= 6;
+}
+
+// tiles of a hand under construction (call tiles first, then closed tiles in draw order)
+struct HandBuilder {
+    uint8_t tiles[MAX_HAND_SIZE];
+    int size = 0;
+    inline void push(uint8_t tile) { tiles[size++] = tile; }
+};
+
+// picks a group start among types [first, last) weighted by the number of ways the pool can supply it
+// returns type index, negative (-1 - type index) for a run, or TILE_TYPES if no group fits
+int pickGroup(Random& random, const TilePool& pool, int first, int last, bool allowRuns) {
+    uint32_t weights[2 * TILE_TYPES];
+    uint32_t total = 0;
+    for (int t = first; t < last; ++t) {
+        uint32_t n = pool.left[t];
+        total += weights[2*t] = n >= 3 ? n * (n - 1) * (n - 2) / 6 : 0;
+        uint32_t run = allowRuns && runStart(t) && t + 2 < last ? n * pool.left[t+1] * pool.left[t+2] : 0;
+        total += weights[2*t+1] = run;
+    }
+    if (total == 0) return TILE_TYPES;
+    uint32_t pick = random.below(total);
+    for (int t = first; t < last; ++t) {
+        if (pick < weights[2*t]) return t;
+        pick -= weights[2*t];
+        if (pick < weights[2*t+1]) return -1 - t;
+        pick -= weights[2*t+1];
+    }
+    return TILE_TYPES;
+}
+
+// picks a pair type among [first, last) weighted by ways (the pool always holds a pair after 4 groups)
+int pickPair(Random& random, const TilePool& pool, int first, int last) {
+    uint32_t weights[TILE_TYPES];
+    uint32_t total = 0;
+    for (int t = first; t < last; ++t)
+        total += weights[t] = pool.left[t] >= 2 ? pool.left[t] * (pool.left[t] - 1) / 2 : 0;
+    uint32_t pick = random.below(total);
+    int t = first;
+    for (; pick >= weights[t]; ++t) pick -= weights[t];
+    return t;
+}
+
+// takes a triplet (or run when typeIndex encodes one) into the builder
+void takeGroup(Random& random, TilePool& pool, HandBuilder& builder, int group) {
+    if (group < 0) {
+        int t = -1 - group;
+        for (int k = 0; k < 3; ++k) builder.push(pool.take(random, t + k));
+    } else {
+        for (int k = 0; k < 3; ++k) builder.push(pool.take(random, group));
+    }
+}
+
+// shuffles closed tiles [start, size) so the winning tile and slot order are random
+void shuffleClosed(Random& random, HandBuilder& builder, int start) {
+    for (int i = builder.size - 1; i > start; --i)
+        std::swap(builder.tiles[i], builder.tiles[start + random.below(i - start + 1)]);
+}
+
+// writes closed tiles after the call tiles, last closed tile into the drawn slot (or left empty for tenpai hands)
+void finishRecord(HandBuilder& builder, CorpusRecord& record, int callTiles, bool drawn) {
+    std::memset(record.tiles, 0, sizeof(record.tiles));
+    int closed = builder.size - callTiles - 1;
+    for (int i = 0; i < callTiles + closed; ++i) record.tiles[i] = builder.tiles[i];
+    if (drawn) record.tiles[DRAWN_I] = builder.tiles[builder.size - 1];
+    record.callTiles = callTiles;
+}
+
+// closed winning hand, mostly 4 groups and a pair with the occasional 7 pairs
+void completeHand(Random& random, TilePool& pool, CorpusRecord& record) {
+    HandBuilder builder;
+    if (random.below(32) == 0) {
+        // 7 distinct pair types without replacement
+        int8_t types[TILE_TYPES];
+        for (int t = 0; t < TILE_TYPES; ++t) types[t] = t;
+        for (int i = 0; i < 7; ++i) {
+            std::swap(types[i], types[i + random.below(TILE_TYPES - i)]);
+            builder.push(pool.take(random, types[i]));
+            builder.push(pool.take(random, types[i]));
+        }
+    } else {
+        for (int g = 0; g < MAX_GROUPS; ++g)
+            takeGroup(random, pool, builder, pickGroup(random, pool, 0, TILE_TYPES, true));
+        int pair = pickPair(random, pool, 0, TILE_TYPES);
+        builder.push(pool.take(random, pair));
+        builder.push(pool.take(random, pair));
+    }
+    shuffleClosed(random, builder, 0);
+    finishRecord(builder, record, 0, true);
+}
+
+// winning hand with 1-4 groups called (runs as chi, triplets as pon or kan)
+void openHand(Random& random, TilePool& pool, CorpusRecord& record) {
+    HandBuilder builder;
+    int calls = 1 + random.below(MAX_GROUPS);
+    record.callMeldCount = calls;
+    for (int m = 0; m < calls; ++m) {
+        int group = pickGroup(random, pool, 0, TILE_TYPES, true);
+        takeGroup(random, pool, builder, group);
+        bool open = true;
+        int size = 3;
+        if (group >= 0 && pool.left[group] && random.below(4) == 0) {
+            // kan, sorted tiles keep the call layout of Hand::call
+            builder.push(pool.take(random, group));
+            open = random.below(2);
+            size = 4;
+        }
+        record.melds[m] = size | (open ? CORPUS_MELD_OPEN : 0);
+    }
+    int callTiles = builder.size;
+    for (int g = calls; g < MAX_GROUPS; ++g)
+        takeGroup(random, pool, builder, pickGroup(random, pool, 0, TILE_TYPES, true));
+    int pair = pickPair(random, pool, 0, TILE_TYPES);
+    builder.push(pool.take(random, pair));
+    builder.push(pool.take(random, pair));
+    shuffleClosed(random, builder, callTiles);
+    finishRecord(builder, record, callTiles, true);
+}
+
+// closed one suit hand built around a shape with several decompositions
+void multiDecompositionHand(Random& random, TilePool& pool, CorpusRecord& record) {
+    HandBuilder builder;
+    int base = 7 + random.below(3) * 9;
+    if (random.below(4) == 0) {
+        // nine gates (1112345678999) plus any tile of the suit
+        const int nineGates[9] = {3, 1, 1, 1, 1, 1, 1, 1, 3};
+        for (int k = 0; k < 9; ++k)
+            for (int c = 0; c < nineGates[k]; ++c) builder.push(pool.take(random, base + k));
+        int extra = base + random.below(9);
+        while (!pool.left[extra]) extra = base + random.below(9);
+        builder.push(pool.take(random, extra));
+    } else {
+        // three identical runs (also three triplets), then one more group and the pair from the same suit
+        int start = base + random.below(7);
+        for (int r = 0; r < 3; ++r)
+            takeGroup(random, pool, builder, -1 - start);
+        int group = pickGroup(random, pool, base, base + 9, true);
+        if (group == TILE_TYPES) group = pickGroup(random, pool, 0, TILE_TYPES, true); // suit exhausted
+        takeGroup(random, pool, builder, group);
+        int pair = random.below(2) ? pickPair(random, pool, base, base + 9) : pickPair(random, pool, 0, TILE_TYPES);
+        builder.push(pool.take(random, pair));
+        builder.push(pool.take(random, pair));
+    }
+    shuffleClosed(random, builder, 0);
+    finishRecord(builder, record, 0, true);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3 || argc > 4) {
+        std::cerr << "usage: corpus_gen <output path> <hands per kind> [seed]" << std::endl;
+        return 1;
+    }
+    uint64_t handsPerKind = std::strtoull(argv[2], nullptr, 10);
+    uint64_t seed = argc == 4 ? std::strtoull(argv[3], nullptr, 10) : 1;
+
+    // full tile set with real multiplicities
+    TilePool fullPool = {};
+    for (int i = 0; i < TILE_COUNT; ++i) {
+        int8_t t = TYPE_INDEX_MAP[*GAME_TILES[i]];
+        ++fullPool.left[t];
+        fullPool.redLeft[t] += GAME_TILES[i].isRed();
+    }
+
+    CorpusHeader header = {};
+    header.magic = CORPUS_MAGIC;
+    header.version = CORPUS_VERSION;
+    header.recordSize = sizeof(CorpusRecord);
+    header.recordCount = handsPerKind * CORPUS_KINDS;
+    header.seed = seed;
+    for (int kind = 0; kind < CORPUS_KINDS; ++kind) header.kindCounts[kind] = handsPerKind;
+
+    std::filesystem::path path(argv[1]);
+    if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path());
+    FILE* file = fopen(argv[1], "wb");
+    if (!file) {
+        std::cerr << "cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+    fwrite(&header, sizeof(header), 1, file);
+
+    // each kind has its own stream so changing one generator leaves the other kinds' hands unchanged
+    std::vector<CorpusRecord> chunk(1 << 16);
+    for (int kind = 0; kind < CORPUS_KINDS; ++kind) {
+        Random random(seed * 0x9e3779b97f4a7c15ull + kind + 1);
+        for (uint64_t written = 0; written < handsPerKind; ) {
+            size_t count = std::min<uint64_t>(chunk.size(), handsPerKind - written);
+            for (size_t i = 0; i < count; ++i) {
+                CorpusRecord& record = chunk[i];
+                std::memset(&record, 0, sizeof(record));
+                TilePool pool = fullPool;
+                switch (kind) {
+                case CorpusComplete: completeHand(random, pool, record); break;
+                case CorpusTenpai: completeHand(random, pool, record); record.tiles[DRAWN_I] = 0; break; // any tile removed from a winning hand leaves it waiting
+                case CorpusOpen: openHand(random, pool, record); break;
+                case CorpusMultiDecomposition: multiDecompositionHand(random, pool, record); break;
+                }
+                record.kind = kind;
+                if (kind != CorpusTenpai && random.below(2)) record.flags |= CORPUS_RON;
+            }
+            fwrite(chunk.data(), sizeof(CorpusRecord), count, file);
+            written += count;
+        }
+    }
+    fclose(file);
+    std::cout << "hand corpus: " << header.recordCount << " hands (" << handsPerKind << " per kind, seed " << seed << ") -> " << argv[1] << std::endl;
+    return 0;
+}
@@ -0,0 +1,44 @@
+// draw odds benchmark, times drawOdds on dealt hands grouped by shanten
+// usage: odds_bench [hands] [draws] [seed]
+#include "hand_odds.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+int main(int argc, char** argv) {
+    int hands = argc > 1 ? std::atoi(argv[1]) : 200;
+    int draws = argc > 2 ? std::min(std::atoi(argv[2]), MAX_ODDS_DRAWS) : 6;
+    uint64_t seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1;
+
+    const int SHANTEN_BUCKETS = 7;
+    int count[SHANTEN_BUCKETS] = {};
+    double seconds[SHANTEN_BUCKETS] = {}, slowest[SHANTEN_BUCKETS] = {}, tenpai[SHANTEN_BUCKETS] = {}, win[SHANTEN_BUCKETS] = {};
+    Board board;
+    board.random.seed(seed);
+    for (int h = 0; h < hands; ++h) {
+        if (h % PLAYER_COUNT == 0) board.nextRound();
+        int8_t playerIndex = h % PLAYER_COUNT;
+        const Hand& hand = board.players[playerIndex].hand;
+        int tiles = 0;
+        for (int t = 0; t < TILE_TYPES; ++t)
+            tiles += hand.counts[t];
+        if (tiles != 13) continue; // dealer holds its first draw
+        int bucket = std::min(shanten(hand.counts, 0), SHANTEN_BUCKETS - 1);
+        auto start = std::chrono::steady_clock::now();
+        DrawOdds odds = drawOdds(hand.counts, 0, board.unseenCounts[playerIndex], draws);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        ++count[bucket];
+        seconds[bucket] += elapsed;
+        slowest[bucket] = std::max(slowest[bucket], elapsed);
+        tenpai[bucket] += odds.tenpai[draws];
+        win[bucket] += odds.win[draws];
+    }
+
+    for (int s = 0; s < SHANTEN_BUCKETS; ++s) {
+        if (!count[s]) continue;
+        std::cout << "shanten " << s << ": " << count[s] << " hands, " << seconds[s] * 1e3 / count[s] << " ms mean, "
+                  << slowest[s] * 1e3 << " ms max, tenpai within " << draws << " draws " << tenpai[s] / count[s]
+                  << ", win " << win[s] / count[s] << std::endl;
+    }
+    return 0;
+}
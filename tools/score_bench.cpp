@@ -0,0 +1,54 @@
+// scoring benchmark over a hand corpus written by corpus_gen
+// usage: score_bench <corpus path> [agari table path] [passes]
+// winning hands go through valueOfHand, tenpai hands through valueOfWaits, timed per corpus kind
+#include "agari.h"
+#include "corpus.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+const char* KIND_NAMES[CORPUS_KINDS] = {"complete", "tenpai", "open", "multi decomposition"};
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 4) {
+        std::cerr << "usage: score_bench <corpus path> [agari table path] [passes]" << std::endl;
+        return 1;
+    }
+    HandCorpus corpus;
+    if (!corpus.open(argv[1])) {
+        std::cerr << "cannot open corpus " << argv[1] << std::endl;
+        return 1;
+    }
+    bool table = argc >= 3 && AgariTable::load(argv[2]);
+    int passes = argc == 4 ? std::atoi(argv[3]) : 1;
+    std::cout << corpus.size() << " hands, seed " << corpus.info().seed << ", agari table " << (table ? "loaded" : "off") << std::endl;
+
+    Board board;
+    Player& player = board.players[0];
+    WaitScores waitScores;
+    size_t first = 0;
+    for (int kind = 0; kind < CORPUS_KINDS; ++kind) {
+        size_t count = corpus.info().kindCounts[kind];
+        int64_t checksum = 0; // sum of basic points, changes when scoring results change
+        auto start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < passes; ++pass) {
+            for (size_t i = first; i < first + count; ++i) {
+                const CorpusRecord& record = corpus[i];
+                loadHand(record, player.hand);
+                player.ronActive = record.flags & CORPUS_RON;
+                if (kind == CorpusTenpai) {
+                    board.valueOfWaits(0, waitScores);
+                    for (int w = 0; w < waitScores.size(); ++w)
+                        checksum += waitScores[w].ron.basicPoints() + waitScores[w].tsumo.basicPoints();
+                } else {
+                    checksum += board.valueOfHand(0).basicPoints();
+                }
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double hands = (double)count * passes;
+        std::cout << KIND_NAMES[kind] << ": " << count << " hands, " << (hands ? seconds / hands * 1e9 : 0) << " ns/hand, checksum " << checksum << std::endl;
+        first += count;
+    }
+    return 0;
+}
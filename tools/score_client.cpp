@@ -0,0 +1,106 @@
+// load generator for score_server, replays the winning hands of a corpus and reports throughput and latency
+// usage: score_client <socket path> <corpus path> [connections] [requests per connection]
+// each connection keeps one request in flight, so latency includes the server's batching delay
+#include "corpus.h"
+#include "score_protocol.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// reads or writes exactly size bytes, false on a closed or failed socket
+template <typename Transfer>
+bool transferAll(Transfer transfer, int fd, uint8_t* data, size_t size) {
+    while (size) {
+        ssize_t done = transfer(fd, data, size);
+        if (done <= 0) return false;
+        data += done;
+        size -= done;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3 || argc > 5) {
+        std::cerr << "usage: score_client <socket path> <corpus path> [connections] [requests per connection]" << std::endl;
+        return 1;
+    }
+    HandCorpus corpus;
+    if (!corpus.open(argv[2])) {
+        std::cerr << "cannot open corpus " << argv[2] << std::endl;
+        return 1;
+    }
+    int connections = argc >= 4 ? std::atoi(argv[3]) : 4;
+    int requestsPerConnection = argc == 5 ? std::atoi(argv[4]) : 100000;
+
+    // winning hands only (tenpai records are not scoreable)
+    std::vector<size_t> hands;
+    for (size_t i = 0; i < corpus.size(); ++i)
+        if (corpus[i].kind != CorpusTenpai) hands.push_back(i);
+    if (hands.empty()) {
+        std::cerr << "corpus has no winning hands" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::vector<float>> latencies(connections);
+    std::vector<int> failures(connections, 0);
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < connections; ++c) {
+        threads.emplace_back([&, c] {
+            sockaddr_un address = {};
+            address.sun_family = AF_UNIX;
+            std::strncpy(address.sun_path, argv[1], sizeof(address.sun_path) - 1);
+            int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd == -1 || connect(fd, (sockaddr*)&address, sizeof(address)) == -1) {
+                failures[c] = requestsPerConnection;
+                return;
+            }
+            latencies[c].reserve(requestsPerConnection);
+            for (int r = 0; r < requestsPerConnection; ++r) {
+                const CorpusRecord& record = corpus[hands[((size_t)r * connections + c) % hands.size()]];
+                ScoreRequest request = {};
+                request.id = r;
+                request.version = SCORE_PROTOCOL_VERSION;
+                request.flags = record.flags & CORPUS_RON ? SCORE_RON : 0;
+                request.roundWind = 0;
+                request.seatWind = c & 0b11;
+                request.hand = record;
+                ScoreResponse response;
+                auto sent = std::chrono::steady_clock::now();
+                if (!transferAll([](int fd, uint8_t* data, size_t size) { return write(fd, data, size); }, fd, (uint8_t*)&request, sizeof(request))
+                    || !transferAll([](int fd, uint8_t* data, size_t size) { return read(fd, data, size); }, fd, (uint8_t*)&response, sizeof(response))) {
+                    failures[c] += requestsPerConnection - r;
+                    break;
+                }
+                latencies[c].push_back(std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - sent).count());
+                failures[c] += response.id != (uint32_t)r || response.status != ScoreOk;
+            }
+            close(fd);
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<float> all;
+    int failed = 0;
+    for (int c = 0; c < connections; ++c) {
+        all.insert(all.end(), latencies[c].begin(), latencies[c].end());
+        failed += failures[c];
+    }
+    if (all.empty()) {
+        std::cerr << "no responses" << std::endl;
+        return 1;
+    }
+    std::sort(all.begin(), all.end());
+    auto percentile = [&](double p) { return all[std::min(all.size() - 1, (size_t)(p * all.size()))]; };
+    std::cout << all.size() << " responses, " << failed << " failed, " << all.size() / seconds << " requests/s, latency us p50 " << percentile(0.5)
+              << " p99 " << percentile(0.99) << " max " << all.back() << std::endl;
+    return failed != 0;
+}
@@ -0,0 +1,164 @@
+// local scoring daemon, answers ScoreRequest messages (see src/score_protocol.h) over a unix domain socket
+// usage: score_server <socket path> [agari table path]
+// requests read from every ready connection in one poll round are scored as one batch, so busy clients share the warm engine
+#include "agari.h"
+#include "score_protocol.h"
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+const size_t READ_CHUNK = 16 * 1024; // bytes read per connection per round (bounds batch size and latency)
+const size_t MAX_PENDING_OUTPUT = 1 << 20; // stop reading from a client that does not read its responses
+
+struct Connection {
+    int fd;
+    std::vector<uint8_t> input; // bytes of an incomplete request
+    std::vector<uint8_t> output; // responses not yet written
+    size_t outputSent = 0;
+    bool closing = false; // peer closed or failed, dropped once output is flushed (or cannot be)
+};
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void requestStop(int) {
+    stopRequested = 1;
+}
+
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags != -1 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1;
+}
+
+// writes as much pending output as the socket takes, false on a broken connection
+bool flush(Connection& connection) {
+    while (connection.outputSent < connection.output.size()) {
+        ssize_t sent = write(connection.fd, connection.output.data() + connection.outputSent, connection.output.size() - connection.outputSent);
+        if (sent > 0) {
+            connection.outputSent += sent;
+        } else if (sent == -1 && errno == EINTR) {
+            continue;
+        } else {
+            return sent == -1 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+    }
+    connection.output.clear();
+    connection.outputSent = 0;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "usage: score_server <socket path> [agari table path]" << std::endl;
+        return 1;
+    }
+    const char* socketPath = argv[1];
+    bool table = argc == 3 && AgariTable::load(argv[2]);
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (std::strlen(socketPath) >= sizeof(address.sun_path)) {
+        std::cerr << "socket path too long" << std::endl;
+        return 1;
+    }
+    std::strcpy(address.sun_path, socketPath);
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socketPath);
+    if (listener == -1 || bind(listener, (sockaddr*)&address, sizeof(address)) == -1 || listen(listener, SOMAXCONN) == -1 || !setNonBlocking(listener)) {
+        std::cerr << "cannot listen on " << socketPath << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    std::signal(SIGPIPE, SIG_IGN);
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+    std::cout << "scoring on " << socketPath << ", agari table " << (table ? "loaded" : "off") << std::endl;
+
+    Board board;
+    std::vector<Connection> connections;
+    std::vector<pollfd> pollFds;
+    std::vector<ScoreRequest> batch;
+    std::vector<size_t> batchOwners; // connection index of each batched request
+    std::vector<ScoreResponse> responses;
+    uint8_t buffer[READ_CHUNK];
+    while (!stopRequested) {
+        pollFds.clear();
+        pollFds.push_back({listener, POLLIN, 0});
+        for (Connection& connection : connections) {
+            short events = !connection.closing && connection.output.size() - connection.outputSent < MAX_PENDING_OUTPUT ? POLLIN : 0;
+            if (connection.outputSent < connection.output.size()) events |= POLLOUT;
+            pollFds.push_back({connection.fd, events, 0});
+        }
+        if (poll(pollFds.data(), pollFds.size(), -1) == -1) {
+            if (errno == EINTR) continue;
+            std::cerr << "poll failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        // gather complete requests of every readable connection in connection order (keeps per connection order)
+        batch.clear();
+        batchOwners.clear();
+        for (size_t c = 0; c < connections.size(); ++c) {
+            Connection& connection = connections[c];
+            short events = pollFds[c + 1].revents;
+            if (!(events & (POLLIN | POLLHUP | POLLERR))) continue;
+            ssize_t received = read(connection.fd, buffer, sizeof(buffer));
+            if (received <= 0) {
+                if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) connection.closing = true;
+                continue;
+            }
+            connection.input.insert(connection.input.end(), buffer, buffer + received);
+            size_t complete = connection.input.size() / sizeof(ScoreRequest);
+            size_t first = batch.size();
+            batch.resize(first + complete);
+            std::memcpy(batch.data() + first, connection.input.data(), complete * sizeof(ScoreRequest));
+            batchOwners.insert(batchOwners.end(), complete, c);
+            connection.input.erase(connection.input.begin(), connection.input.begin() + complete * sizeof(ScoreRequest));
+        }
+
+        // score batch and queue responses
+        responses.resize(batch.size());
+        scoreRequests(board, batch.data(), batch.size(), responses.data());
+        for (size_t r = 0; r < responses.size(); ++r) {
+            std::vector<uint8_t>& output = connections[batchOwners[r]].output;
+            const uint8_t* bytes = (const uint8_t*)&responses[r];
+            output.insert(output.end(), bytes, bytes + sizeof(ScoreResponse));
+        }
+
+        // write responses, drop closed connections
+        for (size_t c = 0; c < connections.size(); ) {
+            Connection& connection = connections[c];
+            bool alive = flush(connection);
+            if (!alive || (connection.closing && connection.output.empty())) {
+                close(connection.fd);
+                connections[c] = std::move(connections.back());
+                connections.pop_back();
+                continue;
+            }
+            ++c;
+        }
+
+        // accept new clients after this round's indices are no longer needed
+        if (pollFds[0].revents & POLLIN) {
+            for (;;) {
+                int fd = accept(listener, nullptr, nullptr);
+                if (fd == -1) break;
+                if (!setNonBlocking(fd)) {
+                    close(fd);
+                    continue;
+                }
+                connections.push_back({fd});
+            }
+        }
+    }
+
+    for (Connection& connection : connections) close(connection.fd);
+    close(listener);
+    unlink(socketPath);
+    return 0;
+}
@@ -0,0 +1,43 @@
+// table multiplexer benchmark, plays many tables with the efficiency bot as batch policy (see efficiency_bot.h)
+// usage: table_bench [tables] [rounds per table] [workers] [max batch] [snapshot path] [batches per snapshot]
+// with a snapshot path, tables resume from the snapshot when it exists and are snapshotted while they play
+#include "efficiency_bot.h"
+#include "table_multiplexer.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+int main(int argc, char** argv) {
+    int tables = argc > 1 ? std::atoi(argv[1]) : 1024;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 4;
+    int workers = argc > 3 ? std::atoi(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+    size_t maxBatch = argc > 4 ? std::atoi(argv[4]) : 4096;
+    const char* snapshotPath = argc > 5 ? argv[5] : nullptr;
+    size_t snapshotInterval = argc > 6 ? std::atoi(argv[6]) : 64;
+
+    TableMultiplexer multiplexer([](Decision* const* decisions, size_t count) {
+        for (size_t d = 0; d < count; ++d)
+            decisions[d]->choice = efficiencyPolicy(*decisions[d]->board, decisions[d]->player, decisions[d]->actions);
+    }, workers, maxBatch);
+
+    auto start = std::chrono::steady_clock::now();
+    bool resumed = false;
+    if (snapshotPath) {
+        multiplexer.checkpoint(snapshotPath, snapshotInterval);
+        resumed = loadSnapshot(snapshotPath, multiplexer.boards, multiplexer.roundsLeft);
+    }
+    if (resumed) {
+        std::cout << "resumed " << multiplexer.boards.size() << " tables from " << snapshotPath << " in "
+                  << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s" << std::endl;
+        multiplexer.resume();
+    } else {
+        multiplexer.run(tables, rounds);
+    }
+    if (!multiplexer.checkpointsWritten()) std::cerr << "snapshot write failed" << std::endl;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << tables << " tables x " << rounds << " rounds on " << workers << " workers: " << multiplexer.decisionCount() << " decisions in "
+              << multiplexer.batchCount() << " batches (" << (multiplexer.batchCount() ? (double)multiplexer.decisionCount() / multiplexer.batchCount() : 0) << " per batch), "
+              << multiplexer.decisionCount() / seconds << " decisions/s" << std::endl;
+    return 0;
+}
@@ -0,0 +1,96 @@
+// tournament runner, plays seeded games between policies and reports placements with 95% confidence intervals
+// usage: tournament <games> <results path, - for none> [rounds per game] [seed] [workers] [policy per entry...]
+// policies: efficiency (shanten and ukeire, see efficiency_bot.h, the default), random (uniform over legal actions),
+// eager (always wins and riichis, never calls, random discards)
+// results ending in .csv are written as csv, anything else as columnar binary (see tournament.h)
+#include "efficiency_bot.h"
+#include "tournament.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+std::mt19937_64& threadRandom() {
+    static thread_local std::mt19937_64 random(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    return random;
+}
+
+int randomPolicy(const Board&, int8_t, const ActionList& actions) {
+    return threadRandom()() % actions.size();
+}
+
+int eagerPolicy(const Board& board, int8_t, const ActionList& actions) {
+    for (int i = 0; i < actions.size(); ++i)
+        if (actions[i].type == Action::Tsumo || actions[i].type == Action::Ron || actions[i].type == Action::Riichi) return i;
+    if (board.phase == Board::CallPhase) return actions.size() - 1; // pass is last
+    int discards = 0;
+    for (int i = 0; i < actions.size(); ++i)
+        discards += actions[i].type == Action::Discard;
+    int pick = threadRandom()() % discards;
+    for (int i = 0; i < actions.size(); ++i)
+        if (actions[i].type == Action::Discard && pick-- == 0) return i;
+    return 0;
+}
+
+// mean and 95% confidence half width from a sum and a sum of squares
+void interval(double sum, double squareSum, uint64_t count, double& mean, double& halfWidth) {
+    mean = count ? sum / count : 0;
+    double variance = count > 1 ? (squareSum - sum * mean) / (count - 1) : 0;
+    halfWidth = count ? 1.96 * std::sqrt(std::max(variance, 0.0) / count) : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: tournament <games> <results path, - for none> [rounds per game] [seed] [workers] [policy per entry...]" << std::endl;
+        return 1;
+    }
+    size_t games = std::strtoull(argv[1], nullptr, 10);
+    const char* path = argv[2];
+    int rounds = argc > 3 ? std::atoi(argv[3]) : PLAYER_COUNT;
+    uint64_t seed = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1;
+    int workers = argc > 5 ? std::atoi(argv[5]) : std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::string> names(PLAYER_COUNT, "efficiency");
+    std::vector<Policy> policies;
+    for (int i = 0; i < PLAYER_COUNT; ++i) {
+        if (argc > 6 + i) names[i] = argv[6 + i];
+        if (names[i] == "efficiency") policies.push_back(efficiencyPolicy<StandardRules>);
+        else if (names[i] == "random") policies.push_back(randomPolicy);
+        else if (names[i] == "eager") policies.push_back(eagerPolicy);
+        else {
+            std::cerr << "unknown policy " << names[i] << std::endl;
+            return 1;
+        }
+    }
+
+    RoundWriter writer;
+    if (std::strcmp(path, "-") != 0 && !writer.open(path)) {
+        std::cerr << "cannot create " << path << std::endl;
+        return 1;
+    }
+    Tournament tournament(policies, workers);
+    auto start = std::chrono::steady_clock::now();
+    tournament.run(games, rounds, seed, std::strcmp(path, "-") != 0 ? &writer : nullptr);
+    writer.close();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << games << " games x " << rounds << " rounds on " << workers << " workers in " << seconds << " s (" << games / seconds << " games/s)" << std::endl;
+
+    std::cout << std::fixed << std::setprecision(3);
+    for (int i = 0; i < PLAYER_COUNT; ++i) {
+        const EntryStats& stats = tournament.stats().entries[i];
+        double rank, rankWidth, score, scoreWidth;
+        interval(stats.rankSum, stats.rankSquareSum, stats.games, rank, rankWidth);
+        interval(stats.scoreSum, stats.scoreSquareSum, stats.games, score, scoreWidth);
+        std::cout << "entry " << i << " (" << names[i] << "): rank " << rank << " +- " << rankWidth << ", placements";
+        for (int r = 0; r < PLAYER_COUNT; ++r)
+            std::cout << " " << (stats.games ? (double)stats.ranks[r] / stats.games : 0);
+        std::cout << ", score " << std::setprecision(0) << score << " +- " << scoreWidth << std::setprecision(3)
+                  << ", win " << (stats.rounds ? (double)stats.wins / stats.rounds : 0)
+                  << " (tsumo " << (stats.wins ? (double)stats.tsumoWins / stats.wins : 0) << ")"
+                  << ", deal in " << (stats.rounds ? (double)stats.dealIns / stats.rounds : 0) << std::endl;
+    }
+    return 0;
+}